@@ -0,0 +1,176 @@
+/*
+ fixed_equivalence.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+// Compara FixedTileCoding e FixedSarsaLambda com TileCoding e GDSarsaLambda no computador.
+//
+// Compilação, a partir da pasta src:
+//     g++ -std=c++17 -O2 -I. -Irl rl/*.cpp ../extras/fixed_equivalence/fixed_equivalence.cpp -o fixed_equivalence -lpthread
+
+#include "RL.h"
+
+#include <cstdio>
+#include <cmath>
+
+using namespace ia::rl;
+
+// corredor com posições 0..9, ações esquerda e direita, recompensa -1 por passo e fim na posição 9
+class PosState : public State {
+public:
+    double m_x;
+
+    PosState(double x) : m_x(x) {}
+
+    std::vector<double> to_vec() const override { return std::vector<double> { m_x }; }
+};
+
+class Corridor : public Env {
+public:
+    int m_pos = 0;
+    double m_r = 0.;
+    Action m_left { "left", 0 }, m_right { "right", 1 };
+
+    State *curr_obs() override { return new PosState(m_pos); }
+    std::vector<Action *> actions() override { return std::vector<Action *> { &m_left, &m_right }; }
+    EnvOutcome *exec_act(Action *a) override {
+        State *o = new PosState(m_pos);
+        if (a->m_num == 0 && m_pos > 0)
+            m_pos--;
+        if (a->m_num == 1)
+            m_pos++;
+        m_r = -1.;
+        return new EnvOutcome(o, a, new PosState(m_pos), m_r, is_terminal());
+    }
+    double last_reward() override { return m_r; }
+    bool is_terminal() override { return m_pos >= 9; }
+    void reset_env() override { m_pos = 0; }
+};
+
+// tiles calculados em Q16.16 e em double para entradas aleatórias
+void compare_tiles()
+{
+    TileCoding tc;
+    tc.seed(7);
+    std::vector<double> widths { 0.37, 12.5 };
+    std::vector<bool> both { true, true }, second { false, true };
+    tc.add_tiling(both, widths, 8);
+    tc.add_tiling(second, widths, 4);
+    FixedTileCoding ftc(tc, 1 << 14);
+
+    Rng rng(3);
+    int lookups = 200000, raw = 0, quantized = 0;
+    Tile fixed_tile, tile;
+    std::vector<double> input(2), quantized_input(2);
+    fixed_t fixed_input[2];
+    for (int n = 0; n < lookups; n++) {
+        input[0] = (rng.uniform() - 0.5) * 20;
+        input[1] = (rng.uniform() - 0.5) * 2000;
+        for (int d = 0; d < 2; d++) {
+            fixed_input[d] = Fixed::from_double(input[d]);
+            quantized_input[d] = Fixed::to_double(fixed_input[d]);
+        }
+        for (int t = 0; t < ftc.num_tilings(); t++) {
+            ftc.get_tile(t, fixed_input, fixed_tile);
+            tc.tiling(t).get_tile(input, tile);
+            if (!(fixed_tile == tile))
+                raw++;
+            tc.tiling(t).get_tile(quantized_input, tile);
+            if (!(fixed_tile == tile))
+                quantized++;
+        }
+    }
+    printf("tiles: %d of %d differ from the double input, %d from the quantized input\n",
+           raw, lookups * ftc.num_tilings(), quantized);
+}
+
+// aprendizagem gulosa no corredor pelos dois caminhos
+void compare_learning()
+{
+    TileCoding tc;
+    std::vector<double> widths { 1 };
+    std::vector<bool> mask { true };
+    tc.add_tiling(mask, widths, 4);
+    LinearFA fa(tc, 0., 2);
+    GDSarsaLambda gd(0.1, 0.9, 1.0, 0., 0.01, true, &fa);
+    FixedTileCoding ftc(tc, 1 << 16);
+    FixedSarsaLambda fs(&ftc, 2, 0.1, 0.9, 1.0, 0., 0.01, true);
+
+    Corridor env;
+    int differing = 0;
+    for (int ep = 0; ep < 200; ep++) {
+        env.reset_env();
+        delete gd.run_learning(&env, 1000);
+        int double_steps = gd.m_curr_step;
+
+        env.reset_env();
+        fixed_t x = Fixed::from_int(env.m_pos);
+        int a = fs.start(&x), fixed_steps = 0;
+        while (!env.is_terminal() && fixed_steps < 1000) {
+            StepOutcome eo = env.step(env.action_list()[a]);
+            x = Fixed::from_int(env.m_pos);
+            a = fs.step(Fixed::from_double(eo.m_r), &x, eo.m_terminated);
+            env.release_state(eo.m_op);
+            fixed_steps++;
+        }
+        if (double_steps != fixed_steps)
+            differing++;
+    }
+
+    double max_diff = 0.;
+    for (int p = 0; p < 10; p++) {
+        for (int a = 0; a < 2; a++) {
+            PosState s(p);
+            fixed_t x = Fixed::from_int(p);
+            double diff = fabs(fa.evaluate(s, *env.action_list()[a]) - Fixed::to_double(fs.q(&x, a)));
+            if (diff > max_diff)
+                max_diff = diff;
+        }
+    }
+    printf("learning: %d of 200 episodes differ in length, max |Q - Q_fixed| %.5f\n", differing, max_diff);
+}
+
+// traços com min_lambda abaixo da resolução de Q16.16 precisam chegar a zero
+void check_trace_decay()
+{
+    TileCoding tc;
+    std::vector<double> widths { 1 };
+    std::vector<bool> mask { true };
+    tc.add_tiling(mask, widths, 4);
+    FixedTileCoding ftc(tc, 1 << 12);
+    FixedSarsaLambda fs(&ftc, 2, 0.1, 0.9, 1.0, 0.1, 1e-7, true);
+
+    // passeio aleatório por muitos tiles para que traços parados se acumulem
+    Rng rng(5);
+    fixed_t x = 0;
+    fs.start(&x);
+    int max_traces = 0;
+    for (int steps = 0; steps < 100000; steps++) {
+        x = Fixed::from_double((rng.uniform() - 0.5) * 2000);
+        fs.step(-Fixed::ONE, &x, false);
+        if (fs.num_traces() > max_traces)
+            max_traces = fs.num_traces();
+    }
+    printf("traces: at most %d of %d active with min_lambda below the Q16.16 resolution\n",
+           max_traces, ftc.size() * 2);
+}
+
+int main()
+{
+    compare_tiles();
+    compare_learning();
+    check_trace_decay();
+    return 0;
+}
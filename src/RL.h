@@ -3,8 +3,33 @@
 #include "rl/episode.hpp"
 #include "rl/envoutcome.hpp"
 #include "rl/gdsarsalambda.hpp"
+#include "rl/trueonlinesarsalambda.hpp"
 #include "rl/env.hpp"
 #include "rl/action.hpp"
+#include "rl/actionmask.hpp"
 #include "rl/linearfa.hpp"
+#include "rl/eligibilitytraces.hpp"
+#include "rl/vecenv.hpp"
+#include "rl/hogwild.hpp"
+#include "rl/policyserver.hpp"
+#include "rl/replaybuffer.hpp"
+#include "rl/prioritizedreplay.hpp"
+#include "rl/dynamodel.hpp"
+#include "rl/policyevaluator.hpp"
+#include "rl/statepool.hpp"
+#include "rl/episodesink.hpp"
+#include "rl/trajectory.hpp"
+#include "rl/rng.hpp"
+#include "rl/mappedfile.hpp"
+#include "rl/snapshot.hpp"
+#include "rl/checkpoint.hpp"
+#include "rl/weightvector.hpp"
+#include "rl/fixedtilecoding.hpp"
+#include "rl/fixedsarsalambda.hpp"
+#include "rl/frozenpolicy.hpp"
+#include "rl/policycompiler.hpp"
+#include "rl/discretizer.hpp"
+#include "rl/tabularq.hpp"
+#include "rl/rlenvadapter.hpp"
 
 using namespace ia::rl;
@@ -43,14 +43,17 @@ namespace ia {
 
 			virtual ~Action() { }
 
-			/// Compara duas ações pelo nome.
+			/// Compara duas ações pelo número.
 			bool operator <(const Action& other) const {
-				return m_name.compare(other.m_name) < 0;
+				return m_num < other.m_num;
 			}
 
-			/// Compara duas ações pelo nome.
+			/// Compara duas ações pelo número.
+			///
+			/// O número identifica a ação nos parâmetros livres de CrossProductFeatures, portanto
+			/// ações diferentes de um mesmo ambiente devem ter números diferentes.
 			bool operator ==(const Action& other) const {
-				return m_name.compare(other.m_name) == 0;
+				return m_num == other.m_num;
 			}
 
 			/// Verifica se esta ação pode ser executada em um estado.
@@ -0,0 +1,101 @@
+/*
+ actionmask.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef ACTIONMASK_H
+#define ACTIONMASK_H
+
+#include <vector>
+#include <cstdint>
+
+namespace ia {
+	namespace rl {
+		/// Conjunto de bits que indica as ações realizáveis em um estado.
+		///
+		/// O bit **i** corresponde à ação de índice **i** em Env::action_list(). Os bits são
+		/// armazenados em palavras de 64 bits reaproveitadas entre as chamadas, portanto
+		/// nenhuma memória é alocada enquanto a quantidade de ações não aumentar.
+		/// @see ia::rl::Env::applicable_mask()
+		class ActionMask {
+		protected:
+			std::vector<uint64_t> m_bits; ///< Palavras com os bits das ações.
+			int m_size; ///< Quantidade de ações.
+
+		public:
+			/// Cria uma máscara sem nenhuma ação.
+			ActionMask() : m_size(0) { }
+
+			/// Redimensiona a máscara e marca todas as ações como não realizáveis.
+			/// @param size Quantidade de ações.
+			void reset(int size) {
+				m_size = size;
+				m_bits.assign((size + 63) / 64, 0);
+			}
+
+			/// Quantidade de ações.
+			int size() const {
+				return m_size;
+			}
+
+			/// Marca uma ação como realizável.
+			/// @param i Índice da ação.
+			void set(int i) {
+				m_bits[i >> 6] |= (uint64_t)1 << (i & 63);
+			}
+
+			/// Marca uma ação como não realizável.
+			/// @param i Índice da ação.
+			void clear(int i) {
+				m_bits[i >> 6] &= ~((uint64_t)1 << (i & 63));
+			}
+
+			/// Verifica se uma ação é realizável.
+			/// @param i Índice da ação.
+			bool test(int i) const {
+				return (m_bits[i >> 6] >> (i & 63)) & 1;
+			}
+
+			/// Encontra a próxima ação realizável.
+			/// @param i Índice a partir do qual a busca é feita.
+			/// @return Índice da primeira ação realizável a partir de **i** ou -1, caso não exista.
+			int next(int i) const {
+				if (i >= m_size)
+					return -1;
+				int w = i >> 6;
+				uint64_t bits = m_bits[w] & (~(uint64_t)0 << (i & 63));
+				while (bits == 0) {
+					if (++w == (int)m_bits.size())
+						return -1;
+					bits = m_bits[w];
+				}
+				int b = 0;
+				while (!((bits >> b) & 1))
+					b++;
+				return (w << 6) + b;
+			}
+
+			/// Quantidade de ações realizáveis.
+			int count() const {
+				int n = 0;
+				for (int i = next(0); i >= 0; i = next(i + 1))
+					n++;
+				return n;
+			}
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ checkpoint.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "checkpoint.hpp"
+#include "mappedfile.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define CHECKPOINT_FSYNC
+#endif
+
+using namespace ia::rl;
+
+static bool sync_close(FILE *f)
+{
+    bool ok = fflush(f) == 0;
+#ifdef CHECKPOINT_FSYNC
+    ok = fsync(fileno(f)) == 0 && ok;
+#endif
+    return fclose(f) == 0 && ok;
+}
+
+static void put(std::vector<char> &out, const void *data, size_t length)
+{
+    out.insert(out.end(), (const char *)data, (const char *)data + length);
+}
+
+Checkpoint::Checkpoint(LinearFA *vfa, const std::string &path, double compact_ratio) :
+    m_vfa(vfa), m_path(path), m_log_path(path + ".log"), m_compact_ratio(compact_ratio),
+    m_base_checksum(0), m_base_length(0), m_log_length(0), m_evictions(0) {}
+
+Checkpoint::~Checkpoint()
+{
+    track(false);
+}
+
+void Checkpoint::track(bool enable)
+{
+    TileCoding &tc = m_vfa->m_safeatures.m_sfeatures;
+    CrossProductFeatures &cpf = m_vfa->m_safeatures;
+
+    tc.m_track_new = enable;
+    tc.m_new_tiles.clear();
+    cpf.m_track_new = enable;
+    cpf.m_new_pairs.clear();
+
+    m_vfa->m_track_dirty = enable;
+    if (enable) {
+        for (int id : m_vfa->m_dirty_ids)
+            m_vfa->m_dirty[id] = 0;
+    }
+    else
+        std::vector<char>().swap(m_vfa->m_dirty);
+    m_vfa->m_dirty_ids.clear();
+}
+
+bool Checkpoint::write_file(const std::string &path, const char *data, size_t length)
+{
+    std::string tmp = path + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if (f == nullptr)
+        return false;
+    bool ok = length == 0 || fwrite(data, 1, length, f) == length;
+    ok = sync_close(f) && ok;
+    return ok && rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool Checkpoint::begin()
+{
+    return compact();
+}
+
+bool Checkpoint::compact()
+{
+    if (!Snapshot::serialize(*m_vfa, m_buffer))
+        return false;
+
+    // the new base goes first: until the empty log replaces the old one, its records
+    // still name the previous base and are skipped by recover()
+    SnapshotHeader h;
+    memcpy(&h, m_buffer.data(), sizeof(h));
+    if (!write_file(m_path, m_buffer.data(), m_buffer.size()) || !write_file(m_log_path, nullptr, 0))
+        return false;
+
+    m_base_checksum = h.m_checksum;
+    m_base_length = h.m_length;
+    m_log_length = 0;
+    m_evictions = m_vfa->evictions();
+    track(true);
+    return true;
+}
+
+bool Checkpoint::checkpoint()
+{
+    if (m_vfa->evictions() != m_evictions)
+        return compact();
+
+    TileCoding &tc = m_vfa->m_safeatures.m_sfeatures;
+    CrossProductFeatures &cpf = m_vfa->m_safeatures;
+    int dim = tc.m_tilings.empty() ? 0 : tc.m_tilings[0].m_widths.size();
+
+    CheckpointRecord r;
+    memset(&r, 0, sizeof(r));
+    memcpy(r.m_magic, "DTCK", 4);
+    r.m_base_checksum = m_base_checksum;
+    r.m_base_length = m_base_length;
+    r.m_tc_feature_id = tc.m_feature_id;
+    r.m_cpf_feature_id = cpf.m_feature_id;
+    r.m_total_weights = m_vfa->m_weights.size();
+    r.m_num_tiles = tc.m_new_tiles.size();
+    r.m_num_pairs = cpf.m_new_pairs.size() / 3;
+    r.m_num_weights = m_vfa->m_dirty_ids.size();
+
+    m_buffer.assign(sizeof(r), 0);
+    for (auto &entry : tc.m_new_tiles) {
+        int32_t row[3] = { entry.first, entry.second.m_hash_code, tc.m_state_features[entry.first][entry.second] };
+        put(m_buffer, row, sizeof(row));
+        for (int i = 0; i < dim; i++) {
+            int32_t coord = i < entry.second.m_tiled_vector.size() ? entry.second.m_tiled_vector[i] : 0;
+            put(m_buffer, &coord, sizeof(int32_t));
+        }
+    }
+    for (int v : cpf.m_new_pairs) {
+        int32_t value = v;
+        put(m_buffer, &value, sizeof(int32_t));
+    }
+    for (int id : m_vfa->m_dirty_ids) {
+        int64_t key = id;
+        put(m_buffer, &key, sizeof(int64_t));
+        double value = m_vfa->m_weights[id];
+        put(m_buffer, &value, sizeof(double));
+    }
+
+    r.m_payload_length = m_buffer.size() - sizeof(r);
+    r.m_payload_checksum = Snapshot::checksum(m_buffer.data() + sizeof(r), r.m_payload_length);
+    memcpy(m_buffer.data(), &r, sizeof(r));
+
+    FILE *f = fopen(m_log_path.c_str(), "ab");
+    if (f == nullptr)
+        return false;
+    bool ok = fwrite(m_buffer.data(), 1, m_buffer.size(), f) == m_buffer.size();
+    if (!sync_close(f) || !ok)
+        return false;
+
+    // the changes are on disk, start recording the next interval
+    m_log_length += m_buffer.size();
+    track(true);
+
+    if (m_log_length > m_compact_ratio * m_base_length)
+        return compact();
+    return true;
+}
+
+bool Checkpoint::recover(LinearFA &lfa, const std::string &path)
+{
+    Snapshot snapshot;
+    if (!snapshot.open(path.c_str()) || !snapshot.load(lfa))
+        return false;
+
+    const SnapshotHeader &base = snapshot.header();
+    MappedFile log;
+    if (!log.open((path + ".log").c_str()))
+        return true;
+
+    TileCoding &tc = lfa.m_safeatures.m_sfeatures;
+    CrossProductFeatures &cpf = lfa.m_safeatures;
+    int dim = base.m_dim;
+    size_t pos = 0;
+    while (pos + sizeof(CheckpointRecord) <= log.size()) {
+        CheckpointRecord r;
+        memcpy(&r, log.data() + pos, sizeof(r));
+        const char *payload = log.data() + pos + sizeof(r);
+        size_t expected = (size_t)r.m_num_tiles * (3 + dim) * sizeof(int32_t) + (size_t)r.m_num_pairs * 3 * sizeof(int32_t) +
+                          (size_t)r.m_num_weights * (sizeof(int64_t) + sizeof(double));
+        // a torn or corrupted record ends the log
+        if (memcmp(r.m_magic, "DTCK", 4) != 0 || r.m_num_tiles < 0 || r.m_num_pairs < 0 || r.m_num_weights < 0 ||
+            r.m_payload_length != expected || pos + sizeof(r) + expected > log.size() ||
+            Snapshot::checksum(payload, expected) != r.m_payload_checksum)
+            break;
+        pos += sizeof(r) + expected;
+
+        if (r.m_base_checksum != base.m_checksum || r.m_base_length != base.m_length)
+            continue;
+
+        for (int k = 0; k < r.m_num_tiles; k++) {
+            int32_t row[3];
+            memcpy(row, payload, sizeof(row));
+            Tile tile;
+            tile.m_hash_code = row[1];
+            tile.m_tiled_vector.resize(dim);
+            memcpy(tile.m_tiled_vector.data(), payload + sizeof(row), dim * sizeof(int32_t));
+            payload += (3 + dim) * sizeof(int32_t);
+            if (row[0] >= 0 && row[0] < tc.m_state_features.size())
+                tc.m_state_features[row[0]][tile] = row[2];
+        }
+        for (int k = 0; k < r.m_num_pairs; k++) {
+            int32_t row[3];
+            memcpy(row, payload, sizeof(row));
+            payload += sizeof(row);
+            cpf.m_action_features[row[0]].m_features_map[row[1]] = row[2];
+        }
+        tc.m_feature_id = r.m_tc_feature_id;
+        cpf.m_feature_id = r.m_cpf_feature_id;
+        lfa.m_weights.resize(r.m_total_weights, lfa.m_default_weight);
+        for (int k = 0; k < r.m_num_weights; k++) {
+            int64_t id;
+            double value;
+            memcpy(&id, payload, sizeof(int64_t));
+            memcpy(&value, payload + sizeof(int64_t), sizeof(double));
+            payload += sizeof(int64_t) + sizeof(double);
+            if (id >= 0 && id < lfa.m_weights.size())
+                lfa.m_weights.set(id, value);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,135 @@
+/*
+ checkpoint.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "linearfa.hpp"
+#include "snapshot.hpp"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace ia {
+	namespace rl {
+		/// Cabeçalho de um registro do log de checkpoints incrementais.
+		///
+		/// Após o cabeçalho, o registro contém os tiles criados (tiling, código hash, id e as
+		/// coordenadas, int32_t), os pares \f$ (s,a) \f$ criados (número da ação, id do estado e id
+		/// do par, int32_t) e os pesos modificados (id, int64_t, e valor, double), nesta ordem.
+		/// @see ia::rl::Checkpoint
+		struct CheckpointRecord {
+			char m_magic[4]; ///< Identificação do registro: "DTCK".
+			uint32_t m_base_checksum; ///< SnapshotHeader::m_checksum do snapshot base.
+			uint64_t m_base_length; ///< SnapshotHeader::m_length do snapshot base.
+			int32_t m_tc_feature_id; ///< Contador de parâmetros livres do TileCoding.
+			int32_t m_cpf_feature_id; ///< Contador de parâmetros livres do CrossProductFeatures.
+			int32_t m_total_weights; ///< Tamanho do vetor de pesos.
+			int32_t m_num_tiles; ///< Quantidade de tiles criados.
+			int32_t m_num_pairs; ///< Quantidade de pares \f$ (s,a) \f$ criados.
+			int32_t m_num_weights; ///< Quantidade de pesos modificados.
+			uint32_t m_payload_checksum; ///< FNV-1a dos dados após o cabeçalho.
+			uint32_t m_payload_length; ///< Tamanho em bytes dos dados após o cabeçalho.
+		};
+
+		/// Checkpoints incrementais de um LinearFA durante a aprendizagem.
+		///
+		/// begin() grava um Snapshot base em **path** e passa a registrar os pesos modificados e os
+		/// parâmetros livres criados. Cada checkpoint() acrescenta ao log **path**.log somente essas
+		/// alterações, portanto o custo de um checkpoint é proporcional às atualizações feitas desde
+		/// o anterior e não ao tamanho do modelo. Quando o log fica maior que **compact_ratio** vezes
+		/// o snapshot base, compact() grava um novo snapshot base e reinicia o log.
+		///
+		/// O snapshot e o log são substituídos com rename(), e cada registro identifica o snapshot
+		/// base ao qual pertence. Assim, recover() sempre reconstrói o último checkpoint completo:
+		/// registros de um snapshot base antigo e um último registro incompleto são ignorados.
+		/// Tiles substituídos por LinearFA::set_feature_budget() não são registrados no log, por isso
+		/// checkpoint() chama compact() sempre que algum tile foi substituído.
+		/// @note Não utilize com LinearFA::set_concurrent(). Chame compact() após LinearFA::reset_params().
+		/// @see ia::rl::Snapshot ia::rl::CheckpointRecord
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::Checkpoint ckpt(&fa, "motor_ctrl.snap");
+		/// ckpt.begin();
+		/// for (int i = 0; i < 100000; i++) {
+		///     env->reset_env();
+		///     delete gdsl.run_learning(env, 500);
+		///     if (i % 100 == 0)
+		///         ckpt.checkpoint();
+		/// }
+		///
+		/// ia::rl::LinearFA restored; // Após uma falha
+		/// ia::rl::Checkpoint::recover(restored, "motor_ctrl.snap");
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class Checkpoint {
+		protected:
+			LinearFA *m_vfa; ///< Aproximador de funções linear.
+			std::string m_path; ///< Caminho do snapshot base.
+			std::string m_log_path; ///< Caminho do log.
+			double m_compact_ratio; ///< Proporção entre o log e o snapshot base que dispara compact().
+			uint32_t m_base_checksum; ///< Checksum do snapshot base atual.
+			uint64_t m_base_length; ///< Tamanho do snapshot base atual.
+			uint64_t m_log_length; ///< Tamanho atual do log.
+			long m_evictions; ///< LinearFA::evictions() no último snapshot base.
+			std::vector<char> m_buffer; ///< Registro em construção.
+
+			/// Ativa ou desativa o registro das alterações do LinearFA e descarta as já registradas.
+			void track(bool enable);
+
+			/// Grava um arquivo de forma atômica, substituindo o existente.
+			static bool write_file(const std::string &path, const char *data, size_t length);
+
+		public:
+			/// Cria um Checkpoint.
+			/// @param vfa Aproximador de funções linear.
+			/// @param path Caminho do snapshot base. O log é gravado em **path**.log.
+			/// @param compact_ratio Proporção entre o log e o snapshot base que dispara compact().
+			/// @note A memória utilizada por **vfa** não é liberada com a destruição de um Checkpoint.
+			Checkpoint(LinearFA *vfa, const std::string &path, double compact_ratio = 0.5);
+
+			/// Para de registrar as alterações do LinearFA.
+			virtual ~Checkpoint();
+
+			/// Grava o snapshot base, reinicia o log e passa a registrar as alterações do LinearFA.
+			/// @return **True** se os arquivos foram gravados ou **false**, caso contrário.
+			bool begin();
+
+			/// Acrescenta ao log as alterações feitas desde o último checkpoint.
+			/// @return **True** se o registro foi gravado ou **false**, caso contrário.
+			bool checkpoint();
+
+			/// Grava um novo snapshot base com o estado atual do LinearFA e reinicia o log.
+			/// @return **True** se os arquivos foram gravados ou **false**, caso contrário.
+			bool compact();
+
+			/// Tamanho atual do log em bytes.
+			uint64_t log_length() const {
+				return m_log_length;
+			}
+
+			/// Reconstrói o último checkpoint completo.
+			/// @param lfa Recebe o snapshot base com todos os registros válidos do log aplicados.
+			/// @param path Caminho do snapshot base.
+			/// @return **True** se o snapshot base é válido ou **false**, caso contrário.
+			static bool recover(LinearFA &lfa, const std::string &path);
+		};
+	}
+}
+
+#endif
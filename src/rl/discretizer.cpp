@@ -0,0 +1,45 @@
+/*
+ discretizer.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "discretizer.hpp"
+
+#include <math.h>
+
+using namespace ia::rl;
+
+GridDiscretizer::GridDiscretizer(const std::vector<double> &min, const std::vector<double> &max, const std::vector<int> &bins) :
+    m_min(min), m_inv_width(min.size()), m_bins(bins), m_num_states(1)
+{
+    for (int i = 0; i < min.size(); i++) {
+        m_inv_width[i] = max[i] > min[i] ? bins[i] / (max[i] - min[i]) : 0.;
+        m_num_states *= bins[i];
+    }
+}
+
+int GridDiscretizer::index(const std::vector<double> &input) const
+{
+    int idx = 0;
+    for (int i = 0; i < m_bins.size(); i++) {
+        int bin = (int)floor((input[i] - m_min[i]) * m_inv_width[i]);
+        if (bin < 0)
+            bin = 0;
+        else if (bin >= m_bins[i])
+            bin = m_bins[i] - 1;
+        idx = idx * m_bins[i] + bin;
+    }
+    return idx;
+}
@@ -0,0 +1,90 @@
+/*
+ discretizer.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef DISCRETIZER_H
+#define DISCRETIZER_H
+
+#include "state.hpp"
+
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Mapeia cada estado de um espaço de estados discreto em um índice entre 0 e num_states() - 1.
+		///
+		/// Para evitar a alocação de State::to_vec() a cada passo, sobrescreva index(const State &)
+		/// lendo as variáveis diretamente do estado do ambiente.
+		/// @see ia::rl::TabularQ ia::rl::GridDiscretizer
+		class Discretizer {
+		public:
+			virtual ~Discretizer() { }
+
+			/// Quantidade de estados.
+			virtual int num_states() const = 0;
+
+			/// Índice do estado correspondente às variáveis de um estado.
+			/// @param input Variáveis do estado, como retornado por State::to_vec().
+			/// @return Índice entre 0 e num_states() - 1.
+			virtual int index(const std::vector<double> &input) const = 0;
+
+			/// Índice de um estado.
+			/// @param s Estado.
+			/// @return Índice entre 0 e num_states() - 1.
+			virtual int index(const State &s) const {
+				return index(s.to_vec());
+			}
+		};
+
+		/// Discretizador em uma grade uniforme.
+		///
+		/// Cada variável é dividida em intervalos de mesma largura entre um mínimo e um máximo.
+		/// Valores fora dos limites são atribuídos ao primeiro ou ao último intervalo.
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// std::vector<double> min { 0, -1 }, max { 10, 1 };
+		/// std::vector<int> bins { 10, 4 };
+		/// ia::rl::GridDiscretizer grid(min, max, bins); // 40 estados
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class GridDiscretizer : public Discretizer {
+		private:
+			std::vector<double> m_min; ///< Menor valor de cada variável.
+			std::vector<double> m_inv_width; ///< Inverso da largura dos intervalos de cada variável.
+			std::vector<int> m_bins; ///< Quantidade de intervalos de cada variável.
+			int m_num_states; ///< Produto das quantidades de intervalos.
+
+		public:
+			/// Cria uma grade uniforme.
+			/// @param min Menor valor de cada variável.
+			/// @param max Maior valor de cada variável.
+			/// @param bins Quantidade de intervalos de cada variável.
+			GridDiscretizer(const std::vector<double> &min, const std::vector<double> &max, const std::vector<int> &bins);
+
+			virtual ~GridDiscretizer() { }
+
+			int num_states() const override {
+				return m_num_states;
+			}
+
+			int index(const std::vector<double> &input) const override;
+
+			using Discretizer::index;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ dynamodel.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "dynamodel.hpp"
+
+using namespace ia::rl;
+
+DynaModel::DynaModel(int capacity, int state_dim) : ReplayBuffer(capacity, state_dim), m_discretizer(nullptr), m_cell(0), m_planning(false) {}
+
+DynaModel::DynaModel(int capacity, int state_dim, const Discretizer *discretizer) :
+    ReplayBuffer(capacity, state_dim), m_discretizer(discretizer), m_cell(0), m_planning(false) {}
+
+DynaModel::~DynaModel()
+{
+    stop_planning();
+}
+
+int DynaModel::find(const State &s, int action)
+{
+    if (m_discretizer != nullptr) {
+        m_cell = (long long)action * m_discretizer->num_states() + m_discretizer->index(s);
+        auto it = m_cells.find(m_cell);
+        return it == m_cells.end() ? -1 : it->second;
+    }
+    s.get_vars(m_key);
+    m_key.resize(m_dim);
+    m_key.push_back(action);
+    auto it = m_index.find(m_key);
+    return it == m_index.end() ? -1 : it->second;
+}
+
+void DynaModel::remember(int i)
+{
+    if (m_discretizer != nullptr)
+        m_cells[m_cell] = i;
+    else
+        m_index[m_key] = i;
+}
+
+void DynaModel::forget(int i)
+{
+    if (m_discretizer != nullptr) {
+        RowState s(state(i), m_dim);
+        m_cells.erase((long long)m_actions[i] * m_discretizer->num_states() + m_discretizer->index(s));
+        return;
+    }
+    const double *row = state(i);
+    m_old_key.assign(row, row + m_dim);
+    m_old_key.push_back(m_actions[i]);
+    m_index.erase(m_old_key);
+}
+
+int DynaModel::add(const State &s, const Action &a, double r, const State &next_s, bool terminal, const ActionMask *next_mask)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int i = find(s, a.m_num);
+    if (i >= 0) {
+        write(i, s, a, r, next_s, terminal, next_mask);
+        return i;
+    }
+
+    // forget the oldest (s,a) when the buffer is full
+    if (m_size == m_capacity)
+        forget(m_next);
+    i = ReplayBuffer::add(s, a, r, next_s, terminal, next_mask);
+    remember(i);
+    return i;
+}
+
+void DynaModel::replay(LinearFA &vfa, const std::vector<Action *> &actions, int batch_size, double alpha, double gamma)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ReplayBuffer::replay(vfa, actions, batch_size, alpha, gamma);
+}
+
+void DynaModel::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ReplayBuffer::clear();
+    m_cells.clear();
+    m_index.clear();
+}
+
+void DynaModel::planning_loop(LinearFA *vfa, std::vector<Action *> actions, double alpha, double gamma)
+{
+    while (m_planning) {
+        replay(*vfa, actions, 1, alpha, gamma);
+        std::this_thread::yield();
+    }
+}
+
+void DynaModel::start_planning(LinearFA *vfa, std::vector<Action *> actions, double alpha, double gamma, int max_params)
+{
+    stop_planning();
+    vfa->set_concurrent(true, max_params);
+    m_planning = true;
+    m_thread = std::thread(&DynaModel::planning_loop, this, vfa, actions, alpha, gamma);
+}
+
+void DynaModel::stop_planning()
+{
+    m_planning = false;
+    if (m_thread.joinable())
+        m_thread.join();
+}
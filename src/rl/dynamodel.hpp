@@ -0,0 +1,133 @@
+/*
+ dynamodel.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef DYNAMODEL_H
+#define DYNAMODEL_H
+
+#include "replaybuffer.hpp"
+#include "discretizer.hpp"
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+namespace ia {
+	namespace rl {
+		/// Modelo tabular do ambiente para planejamento no estilo Dyna-Q.
+		///
+		/// Guarda, para cada par \f$ (s,a) \f$ visitado, o último resultado \f$ (r,s') \f$ observado. Em
+		/// ambientes contínuos, os estados são agrupados pelo índice de um Discretizer e cada célula
+		/// guarda o último resultado observado a partir de qualquer estado dentro dela. Sem um
+		/// Discretizer, somente estados com variáveis idênticas compartilham uma entrada. O
+		/// planejamento sorteia pares conhecidos e atualiza o LinearFA com o alvo do Q-Learning, como
+		/// se as transições tivessem sido executadas no ambiente. Os resultados ficam nos vetores
+		/// contíguos do ReplayBuffer e, quando a capacidade é atingida, o par mais antigo é esquecido.
+		///
+		/// O planejamento pode ser executado entre os passos reais por GDSarsaLambda (veja
+		/// GDSarsaLambda::m_planning_steps) ou continuamente em outra thread com start_planning().
+		/// @see ia::rl::ReplayBuffer ia::rl::GDSarsaLambda
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::GridDiscretizer grid(min, max, bins); // Células do modelo
+		/// ia::rl::DynaModel model(5000, 2, &grid); // Modelo com até 5000 pares (célula,a) de estados com 2 variáveis
+		/// gdsl.m_replay = &model; // O agente grava as transições no modelo
+		/// gdsl.m_planning_steps = 10; // 10 atualizações simuladas a cada passo real
+		/// delete gdsl.run_learning(env, 100);
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class DynaModel : public ReplayBuffer {
+		private:
+			const Discretizer *m_discretizer; ///< Agrupa os estados em células ou nullptr para usar as variáveis.
+			std::map<long long, int> m_cells; ///< Posição de cada par \f$ (célula,a) \f$ no buffer.
+			long long m_cell; ///< Chave do par \f$ (célula,a) \f$ procurado por find().
+			std::map<std::vector<double>, int> m_index; ///< Posição de cada par \f$ (s,a) \f$ no buffer, sem Discretizer.
+			std::vector<double> m_key; ///< Chave procurada por find(): variáveis de **s** seguidas do número da ação.
+			std::vector<double> m_old_key; ///< Chave de trabalho de forget().
+
+			std::mutex m_mutex; ///< Protege o modelo durante o planejamento em outra thread.
+			std::thread m_thread; ///< Thread de planejamento.
+			std::atomic<bool> m_planning; ///< Mantém a thread de planejamento em execução.
+
+			/// Procura a posição de um par \f$ (s,a) \f$ e guarda a sua chave para remember().
+			/// @param s Estado.
+			/// @param action Número da ação.
+			/// @return Índice da transição ou -1, caso o par não seja conhecido.
+			int find(const State &s, int action);
+
+			/// Associa a chave do último find() a uma posição do buffer.
+			/// @param i Índice da transição.
+			void remember(int i);
+
+			/// Remove a chave do par \f$ (s,a) \f$ gravado em uma posição do buffer.
+			/// @param i Índice da transição.
+			void forget(int i);
+
+			/// Laço executado pela thread de planejamento.
+			void planning_loop(LinearFA *vfa, std::vector<Action *> actions, double alpha, double gamma);
+
+		public:
+			/// Cria um modelo vazio.
+			/// @param capacity Quantidade máxima de pares \f$ (s,a) \f$.
+			/// @param state_dim Quantidade de variáveis de um estado.
+			DynaModel(int capacity, int state_dim);
+
+			/// Cria um modelo vazio que agrupa os estados nas células de um Discretizer.
+			/// @param capacity Quantidade máxima de pares \f$ (célula,a) \f$.
+			/// @param state_dim Quantidade de variáveis de um estado.
+			/// @param discretizer Discretizador dos estados. Sua memória não é liberada pelo DynaModel.
+			/// @see ia::rl::GridDiscretizer
+			DynaModel(int capacity, int state_dim, const Discretizer *discretizer);
+
+			/// Destrutor.
+			///
+			/// Encerra a thread de planejamento, caso esteja em execução.
+			virtual ~DynaModel();
+
+			/// Grava o último resultado observado para o par \f$ (s,a) \f$ ou para a célula de **s**.
+			/// @see ReplayBuffer::add()
+			int add(const State &s, const Action &a, double r, const State &next_s, bool terminal,
+			        const ActionMask *next_mask = nullptr) override;
+
+			/// Executa atualizações simuladas sorteando pares \f$ (s,a) \f$ conhecidos.
+			/// @see ReplayBuffer::replay()
+			void replay(LinearFA &vfa, const std::vector<Action *> &actions, int batch_size, double alpha, double gamma) override;
+
+			/// Descarta todos os pares \f$ (s,a) \f$ conhecidos.
+			void clear() override;
+
+			/// Inicia o planejamento contínuo em outra thread.
+			///
+			/// O LinearFA é colocado no modo concorrente, portanto os pesos são atualizados pelas duas
+			/// threads sem sincronização (estilo Hogwild).
+			/// @param vfa Aproximador de funções linear.
+			/// @param actions Ações do ambiente.
+			/// @param alpha Taxa de aprendizagem do planejamento.
+			/// @param gamma Desconto do retorno.
+			/// @param max_params Quantidade de pesos reservados no LinearFA.
+			/// @see ia::rl::LinearFA::set_concurrent()
+			void start_planning(LinearFA *vfa, std::vector<Action *> actions, double alpha, double gamma, int max_params);
+
+			/// Encerra o planejamento contínuo.
+			/// @note O LinearFA continua no modo concorrente. Chame LinearFA::set_concurrent(false), caso necessário.
+			void stop_planning();
+		};
+	}
+}
+
+#endif
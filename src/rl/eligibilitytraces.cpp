@@ -0,0 +1,139 @@
+/*
+ eligibilitytraces.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "eligibilitytraces.hpp"
+
+#include <math.h>
+
+using namespace ia::rl;
+
+static const unsigned int NO_GENERATION = ~0u;
+
+EligibilityTraces::EligibilityTraces() {}
+
+void EligibilityTraces::activate(int id)
+{
+    if (id >= (int)m_values.size()) {
+        m_values.resize(id + 1, 0.);
+        m_is_active.resize(id + 1, 0);
+    }
+    if (!m_is_active[id]) {
+        m_is_active[id] = 1;
+        m_active.push_back(id);
+        if (id < (int)m_generation.size())
+            m_generation[id] = NO_GENERATION;
+    }
+}
+
+bool EligibilityTraces::drop_recycled(const LinearFA &vfa, int id)
+{
+    if (id >= (int)m_generation.size())
+        m_generation.resize(id + 1, NO_GENERATION);
+    unsigned int g = vfa.generation(id);
+    if (m_generation[id] == g)
+        return false;
+    bool first = m_generation[id] == NO_GENERATION;
+    m_generation[id] = g;
+    if (first)
+        return false;
+
+    // the id now belongs to another tile, so the old trace must not credit it
+    m_values.set(id, 0.);
+    return true;
+}
+
+void EligibilityTraces::accumulate(int id, double value)
+{
+    activate(id);
+    m_values.add(id, value);
+}
+
+void EligibilityTraces::replace(int id, double value)
+{
+    activate(id);
+    m_values.set(id, value);
+}
+
+void EligibilityTraces::update(LinearFA &vfa, double step, double decay, double min_trace)
+{
+    if (m_values.precision() != vfa.trace_precision())
+        m_values.set_precision(vfa.trace_precision());
+
+    bool budget = vfa.feature_budget() > 0;
+    int n = m_active.size();
+    for (int i = 0; i < n; i++) {
+        int id = m_active[i];
+        if (budget && drop_recycled(vfa, id))
+            continue;
+        double e = m_values[id];
+        vfa.update_weight(id, step * e);
+        m_values.scale(id, decay);
+    }
+
+    // descarta os traços pequenos mantendo a lista compacta
+    int kept = 0;
+    for (int i = 0; i < n; i++) {
+        int id = m_active[i];
+        if (m_values[id] < min_trace) {
+            m_values.set(id, 0.);
+            m_is_active[id] = 0;
+        }
+        else m_active[kept++] = id;
+    }
+    m_active.resize(kept);
+}
+
+void EligibilityTraces::scale(double factor)
+{
+    for (int id : m_active)
+        m_values.scale(id, factor);
+}
+
+void EligibilityTraces::apply(LinearFA &vfa, double step)
+{
+    if (m_values.precision() != vfa.trace_precision())
+        m_values.set_precision(vfa.trace_precision());
+
+    bool budget = vfa.feature_budget() > 0;
+    for (int id : m_active) {
+        if (budget && drop_recycled(vfa, id))
+            continue;
+        vfa.update_weight(id, step * m_values[id]);
+    }
+}
+
+void EligibilityTraces::prune(double min_trace)
+{
+    int kept = 0;
+    for (int id : m_active) {
+        if (fabs(m_values[id]) < min_trace) {
+            m_values.set(id, 0.);
+            m_is_active[id] = 0;
+        }
+        else m_active[kept++] = id;
+    }
+    m_active.resize(kept);
+}
+
+void EligibilityTraces::clear()
+{
+    for (int id : m_active) {
+        m_values.set(id, 0.);
+        m_is_active[id] = 0;
+    }
+    m_active.clear();
+}
@@ -0,0 +1,120 @@
+/*
+ eligibilitytraces.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef ELIGIBILITYTRACES_H
+#define ELIGIBILITYTRACES_H
+
+#include "linearfa.hpp"
+
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Armazena os traços de elegibilidade dos parâmetros livres de um LinearFA.
+		///
+		/// O valor de cada traço fica em um vetor indexado diretamente pelo id do parâmetro livre
+		/// e os ids com traço ativo ficam em uma lista compacta. Assim, atualizar, decair e descartar
+		/// traços custa O(traços ativos), assim como reiniciar os traços entre episódios. Os valores
+		/// são armazenados com a precisão de LinearFA::trace_precision().
+		/// @see ia::rl::GDSarsaLambda
+		class EligibilityTraces {
+		private:
+			WeightVector m_values; ///< Valor do traço indexado pelo id do parâmetro livre.
+			std::vector<char> m_is_active; ///< Indica se o id do parâmetro livre está em m_active.
+			std::vector<int> m_active; ///< Ids dos parâmetros livres com traço ativo.
+			/// LinearFA::generation() de cada id na primeira atualização do traço. Só é utilizado
+			/// quando o LinearFA tem um limite de tiles.
+			std::vector<unsigned int> m_generation;
+
+			/// Garante que o id do parâmetro livre caiba em m_values e o marca como ativo.
+			/// @param id Id do parâmetro livre.
+			void activate(int id);
+
+			/// Descarta o traço de um par \f$ (s,a) \f$ reaproveitado pelo LinearFA desde a ativação do traço.
+			/// @param vfa Aproximador de funções linear.
+			/// @param id Id do parâmetro livre com traço ativo.
+			/// @return **True** se o traço foi descartado ou **false**, caso contrário.
+			bool drop_recycled(const LinearFA &vfa, int id);
+
+		public:
+			/// Cria um conjunto de traços vazio.
+			EligibilityTraces();
+
+			virtual ~EligibilityTraces() { }
+
+			/// Soma um valor ao traço de um parâmetro livre (traço acumulativo).
+			/// @param id Id do parâmetro livre.
+			/// @param value Valor somado ao traço.
+			void accumulate(int id, double value);
+
+			/// Substitui o traço de um parâmetro livre (traço de substituição).
+			/// @param id Id do parâmetro livre.
+			/// @param value Novo valor do traço.
+			void replace(int id, double value);
+
+			/// Obtém o traço de um parâmetro livre.
+			/// @param id Id do parâmetro livre.
+			/// @return Valor do traço ou 0, caso o traço não esteja ativo.
+			double get(int id) const {
+				if (id < (int)m_values.size())
+					return m_values[id];
+				return 0.;
+			}
+
+			/// Atualiza os pesos, decai os traços e descarta os traços pequenos em uma única passada.
+			///
+			/// Para cada traço ativo \f$ e_i \f$ é feito \f$ w_i \leftarrow w_i + step \cdot e_i \f$ e
+			/// \f$ e_i \leftarrow decay \cdot e_i \f$. Traços menores que **min_trace** são descartados,
+			/// assim como os traços de pares reaproveitados pelo limite de LinearFA::set_feature_budget().
+			/// @param vfa Aproximador de funções linear cujos pesos serão atualizados.
+			/// @param step Passo da atualização, normalmente \f$ \alpha \delta \f$.
+			/// @param decay Fator de decaimento, normalmente \f$ \gamma \lambda \f$.
+			/// @param min_trace Valor mínimo para um traço continuar ativo.
+			void update(LinearFA &vfa, double step, double decay, double min_trace);
+
+			/// Multiplica todos os traços ativos por um fator.
+			/// @param factor Fator de multiplicação.
+			void scale(double factor);
+
+			/// Soma \f$ step \cdot e_i \f$ ao peso de cada parâmetro livre com traço ativo.
+			/// @param vfa Aproximador de funções linear cujos pesos serão atualizados.
+			/// @param step Passo da atualização.
+			void apply(LinearFA &vfa, double step);
+
+			/// Descarta os traços cujo valor absoluto é menor que **min_trace**.
+			/// @param min_trace Valor mínimo para um traço continuar ativo.
+			void prune(double min_trace);
+
+			/// Quantidade de traços ativos.
+			/// @return Quantidade de traços ativos.
+			int size() const {
+				return m_active.size();
+			}
+
+			/// Ids dos parâmetros livres com traço ativo.
+			/// @return Lista dos ids com traço ativo.
+			const std::vector<int> &active() const {
+				return m_active;
+			}
+
+			/// Descarta todos os traços em O(traços ativos).
+			void clear();
+		};
+	}
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "action.hpp"
 #include "state.hpp"
 #include "envoutcome.hpp"
+#include "actionmask.hpp"
 
 #include <vector>
 
@@ -28,7 +29,13 @@ namespace ia {
 	namespace rl {
 		/// Estrutura de um ambiente de aprendizagem por reforço.
 		class Env {
+		protected:
+			std::vector<Action *> m_action_list; ///< Cópia de actions() mantida por action_list().
+			Env *m_action_list_owner; ///< Ambiente que preencheu m_action_list.
+
 		public:
+			Env() : m_action_list_owner(nullptr) { }
+
 			virtual ~Env() { }
 			
 			/// Obtém o estado atual do ambiente.
@@ -52,10 +59,87 @@ namespace ia {
 				return acts;
 			}
 
+			/// Obtém todas as ações disponíveis sem criar um novo vetor.
+			///
+			/// actions() é chamado somente na primeira vez. É assumido que as ações disponíveis não
+			/// mudam durante a existência do ambiente.
+			/// @return Vetor com todas as ações disponíveis.
+			const std::vector<Action *> &action_list() {
+				if (m_action_list_owner != this) {
+					m_action_list = actions();
+					m_action_list_owner = this;
+				}
+				return m_action_list;
+			}
+
+			/// Marca as ações realizáveis em um estado do ambiente.
+			///
+			/// A implementação padrão chama Action::is_aplicable() para cada ação. Sobrescreva esta
+			/// função para preencher a máscara diretamente, por exemplo a partir de uma máscara
+			/// calculada previamente para cada tipo de estado.
+			/// @param state Estado atual do ambiente.
+			/// @param mask Recebe um bit para cada ação de action_list().
+			virtual void applicable_mask(State *state, ActionMask &mask) {
+				const std::vector<Action *> &acts = action_list();
+				mask.reset(acts.size());
+				for (int i = 0; i < acts.size(); i++) {
+					if (acts[i]->is_aplicable(state))
+						mask.set(i);
+				}
+			}
+
+			/// Obtém as ações realizáveis em um estado do ambiente sem alocar memória.
+			/// @param state Estado atual do ambiente.
+			/// @param mask Recebe as ações realizáveis de applicable_mask().
+			/// @param acts Recebe as ações realizáveis. O vetor é reaproveitado.
+			void applicable_actions(State *state, ActionMask &mask, std::vector<Action *> &acts) {
+				const std::vector<Action *> &all = action_list();
+				applicable_mask(state, mask);
+				acts.clear();
+				for (int i = mask.next(0); i >= 0; i = mask.next(i + 1))
+					acts.push_back(all[i]);
+			}
+
 			/// Executa uma ação no ambiente.
 			/// @param a Ação para executar no ambiente.
 			/// @return Estrutura EnvOutcome como resultado da ação realizada no ambiente.
 			virtual EnvOutcome *exec_act(Action *a) = 0;
+
+			/// Executa uma ação no ambiente e retorna o resultado por valor.
+			///
+			/// A implementação padrão chama exec_act() e destrói o EnvOutcome retornado, sem destruir
+			/// seus estados. Sobrescreva esta função para evitar a alocação do EnvOutcome a cada passo.
+			/// @param a Ação para executar no ambiente.
+			/// @return Próximo estado, recompensa e fim do episódio.
+			/// @see ia::rl::StepOutcome
+			virtual StepOutcome step(Action *a) {
+				EnvOutcome *eo = exec_act(a);
+				StepOutcome so(eo->m_op, eo->m_r, eo->m_terminated);
+				delete eo;
+				return so;
+			}
+
+			/// Indica se os estados retornados por curr_obs() e step() pertencem ao ambiente.
+			///
+			/// Ambientes que reaproveitam seus estados, por exemplo com um StatePool, devem retornar
+			/// **true** para que os agentes e o Episode não os destruam.
+			/// @return **True** se os estados pertencem ao ambiente ou **false**, caso contrário.
+			/// @see ia::rl::StatePool
+			virtual bool pooled_states() {
+				return false;
+			}
+
+			/// Libera um estado retornado por curr_obs() ou step() que não será mais utilizado.
+			///
+			/// Por padrão, destrói o estado caso ele não pertença ao ambiente. Ambientes com
+			/// pooled_states() devem sobrescrever esta função para devolver o estado ao seu StatePool;
+			/// caso contrário, os estados só são reaproveitados em reset_env().
+			/// @param s Estado.
+			/// @see ia::rl::StatePool::release()
+			virtual void release_state(State *s) {
+				if (!pooled_states())
+					delete s;
+			}
 			
 			/// Última recompensa recebida.
 			/// @return Última recompensa recebida.
@@ -67,6 +151,15 @@ namespace ia {
 
 			/// Reinicia o ambiente em um estado inicial.
 			virtual void reset_env() = 0;
+
+			/// Cria uma cópia independente do ambiente.
+			///
+			/// Implemente esta função para permitir a execução de episódios em paralelo.
+			/// @return Nova cópia do ambiente, que deve ser destruída por quem a chamou.
+			/// @see ia::rl::PolicyEvaluator::evaluate()
+			virtual Env *clone() {
+				return nullptr;
+			}
 		};
 	}
 }
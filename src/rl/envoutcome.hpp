@@ -55,6 +55,21 @@ namespace ia {
 				else return os << *eo.m_o << ";" << *eo.m_a << ";" << eo.m_r << ";" << *eo.m_op << ";" << eo.m_terminated;
 			}
 		};
+
+		/// Resultado de um passo no ambiente retornado por valor.
+		///
+		/// Versão compacta de EnvOutcome usada por Env::step(), que não exige nenhuma alocação
+		/// para ser retornada.
+		/// @see ia::rl::Env::step()
+		class StepOutcome {
+		public:
+			State *m_op; ///< Próximo estado.
+			double m_r; ///< Recompensa recebida.
+			bool m_terminated; ///< Fim do episódio.
+
+			/// Cria um StepOutcome.
+			StepOutcome(State *op, double r, bool terminated) : m_op(op), m_r(r), m_terminated(terminated) { }
+		};
 	}
 }
 
@@ -19,21 +19,23 @@
 
 using namespace ia::rl;
 
-Episode::Episode() {}
+Episode::Episode() : m_owns_states(true) {}
 
-Episode::Episode(State *init_state)
+Episode::Episode(State *init_state) : m_owns_states(true)
 {
     add_state(init_state);
 }
 
 Episode::Episode(const Episode &episode) :
     m_state_seq(episode.m_state_seq), m_action_seq(episode.m_action_seq),
-    m_reward_seq(episode.m_reward_seq)
+    m_reward_seq(episode.m_reward_seq), m_owns_states(episode.m_owns_states)
 {
 }
 
 Episode::~Episode()
 {
+    if (!m_owns_states)
+        return;
     for (State *s : m_state_seq)
         delete s;
 }
@@ -33,6 +33,9 @@ namespace ia {
 			std::vector<State *> m_state_seq; ///< Sequência de estados de um episódio.
 			std::vector<Action *> m_action_seq; ///< Sequência de ações de um episódio.
 			std::vector<double> m_reward_seq; ///< Sequência de recompensas de um episódio.
+			/// Indica se os estados da sequência são destruídos com o episódio.
+			/// @see ia::rl::Env::pooled_states()
+			bool m_owns_states;
 			
 			/// Cria um episódio sem nenhuma sequência de estados, ações ou recompensas.
 			Episode();
@@ -48,8 +51,7 @@ namespace ia {
 
 			/// Destrutor.
 			///
-			/// Destrói toda a sequência de estados.
-			/// @note Este destrutor não destrói os objetos State de um episódio.
+			/// Destrói toda a sequência de estados, caso m_owns_states seja **true**.
 			virtual ~Episode();
 			
 			/// Adiciona um estado na sequência.
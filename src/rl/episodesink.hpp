@@ -0,0 +1,53 @@
+/*
+ episodesink.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef EPISODESINK_H
+#define EPISODESINK_H
+
+#include "state.hpp"
+#include "action.hpp"
+
+namespace ia {
+	namespace rl {
+		/// Destino das transições de um episódio.
+		///
+		/// Quando um EpisodeSink é atribuído a GDSarsaLambda::m_sink, as transições deixam de ser
+		/// acumuladas no Episode retornado por run_learning() e são repassadas para o EpisodeSink
+		/// assim que executadas, mantendo constante a memória utilizada em episódios longos.
+		/// @see ia::rl::TrajectoryWriter
+		class EpisodeSink {
+		public:
+			virtual ~EpisodeSink() { }
+
+			/// Inicia um novo episódio.
+			/// @param s Estado inicial.
+			virtual void begin_episode(const State &s) = 0;
+
+			/// Recebe a tupla \f$ (a, r, s') \f$ de um passo do episódio.
+			/// @param a Ação executada.
+			/// @param r Recompensa recebida.
+			/// @param next_s Próximo estado.
+			/// @param terminal Indica se **next_s** é um estado terminal.
+			virtual void transition(const Action &a, double r, const State &next_s, bool terminal) = 0;
+
+			/// Finaliza o episódio corrente.
+			virtual void end_episode() { }
+		};
+	}
+}
+
+#endif
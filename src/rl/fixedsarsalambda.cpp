@@ -0,0 +1,145 @@
+/*
+ fixedsarsalambda.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "fixedsarsalambda.hpp"
+
+using namespace ia::rl;
+
+FixedSarsaLambda::FixedSarsaLambda(const FixedTileCoding *tc, int num_actions, double alpha, double lambda, double gamma, double E,
+                                   double min_lambda, bool replace_traces) :
+    m_tc(tc), m_num_actions(num_actions), m_alpha(Fixed::from_double(alpha)), m_gamma(Fixed::from_double(gamma)),
+    m_decay(Fixed::from_double(lambda * gamma)), m_min_trace(Fixed::from_double(min_lambda)),
+    m_E(E >= 1. ? UINT32_MAX : (uint32_t)(E * 4294967296.)), m_replace_traces(replace_traces), m_rng(1),
+    m_weights(tc->size() * num_actions, 0), m_traces(tc->size() * num_actions, 0), m_is_active(tc->size() * num_actions, 0),
+    m_curr_ids(tc->num_tilings()), m_next_ids(tc->num_tilings()), m_action(0)
+{
+    // a replacing trace starts at ONE and survives k decays, so at most
+    // num_tilings * (k + 1) traces are active and the loop never allocates
+    int capacity = tc->size() * num_actions;
+    if (replace_traces && m_decay < Fixed::ONE) {
+        int k = 0;
+        for (fixed_t t = Fixed::ONE; t > 0 && t >= m_min_trace && tc->num_tilings() * (k + 1) < capacity; k++)
+            t = Fixed::mul_floor(t, m_decay);
+        if (tc->num_tilings() * (k + 1) < capacity)
+            capacity = tc->num_tilings() * (k + 1);
+    }
+    m_active.reserve(capacity);
+}
+
+fixed_t FixedSarsaLambda::value(const int *ids, int a) const
+{
+    fixed_t val = 0;
+    for (int t = 0; t < m_tc->num_tilings(); t++)
+        val += m_weights[ids[t] * m_num_actions + a];
+    return val;
+}
+
+int FixedSarsaLambda::best_action(const int *ids, fixed_t &q) const
+{
+    int best = 0;
+    q = value(ids, 0);
+    for (int a = 1; a < m_num_actions; a++) {
+        fixed_t val = value(ids, a);
+        if (val > q) {
+            q = val;
+            best = a;
+        }
+    }
+    return best;
+}
+
+int FixedSarsaLambda::egreedy_action(const int *ids, fixed_t &q)
+{
+    if (next_rand() >= m_E)
+        return best_action(ids, q);
+    int a = (int)(((uint64_t)next_rand() * (uint32_t)m_num_actions) >> 32);
+    q = value(ids, a);
+    return a;
+}
+
+int FixedSarsaLambda::start(const fixed_t *input)
+{
+    for (int id : m_active) {
+        m_traces[id] = 0;
+        m_is_active[id] = 0;
+    }
+    m_active.clear();
+
+    fixed_t q;
+    m_tc->features(input, m_curr_ids.data());
+    m_action = egreedy_action(m_curr_ids.data(), q);
+    return m_action;
+}
+
+int FixedSarsaLambda::step(fixed_t r, const fixed_t *next_input, bool terminal)
+{
+    int n = m_tc->num_tilings();
+
+    // get Q-value and manage traces
+    fixed_t curr_Q = 0;
+    for (int t = 0; t < n; t++) {
+        int id = m_curr_ids[t] * m_num_actions + m_action;
+        curr_Q += m_weights[id];
+        if (!m_is_active[id]) {
+            m_is_active[id] = 1;
+            m_active.push_back(id);
+        }
+        if (m_replace_traces)
+            m_traces[id] = Fixed::ONE;
+        else
+            m_traces[id] += Fixed::ONE;
+    }
+
+    // determine next Q-value for outcome state
+    fixed_t next_Q;
+    m_tc->features(next_input, m_next_ids.data());
+    int next_a = egreedy_action(m_next_ids.data(), next_Q);
+    if (terminal)
+        next_Q = 0;
+
+    // update weights, then decay and delete from tracking if too small
+    fixed_t delta = r + Fixed::mul(m_gamma, next_Q) - curr_Q;
+    fixed_t step = Fixed::mul(m_alpha, delta);
+    int kept = 0;
+    for (int id : m_active) {
+        m_weights[id] += Fixed::mul(step, m_traces[id]);
+        m_traces[id] = Fixed::mul_floor(m_traces[id], m_decay);
+        if (m_traces[id] <= 0 || m_traces[id] < m_min_trace) {
+            m_traces[id] = 0;
+            m_is_active[id] = 0;
+        }
+        else m_active[kept++] = id;
+    }
+    m_active.resize(kept);
+
+    m_curr_ids.swap(m_next_ids);
+    m_action = next_a;
+    return next_a;
+}
+
+fixed_t FixedSarsaLambda::q(const fixed_t *input, int a)
+{
+    m_tc->features(input, m_next_ids.data());
+    return value(m_next_ids.data(), a);
+}
+
+int FixedSarsaLambda::greedy_action(const fixed_t *input)
+{
+    fixed_t q;
+    m_tc->features(input, m_next_ids.data());
+    return best_action(m_next_ids.data(), q);
+}
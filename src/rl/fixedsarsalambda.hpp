@@ -0,0 +1,160 @@
+/*
+ fixedsarsalambda.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef FIXEDSARSALAMBDA_H
+#define FIXEDSARSALAMBDA_H
+
+#include "fixedtilecoding.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Algoritmo Sarsa Lambda em ponto fixo para microcontroladores sem unidade de ponto flutuante.
+		///
+		/// Mesmo algoritmo de GDSarsaLambda, com pesos, traços de elegibilidade, erro TD e valores
+		/// **Q** em Q16.16 e parâmetros livres de FixedTileCoding. Toda a memória é alocada na
+		/// construção e cada passo usa somente aritmética inteira, por isso a aprendizagem pode
+		/// rodar no próprio dispositivo dentro do laço de controle.
+		///
+		/// Como o laço de controle é do dispositivo, não há Env: as entradas são lidas em Q16.16 e as
+		/// ações são índices de 0 a num_actions - 1. O id do peso do par \f$ (s,a) \f$ é
+		/// \f$ s \cdot num\_actions + a \f$, como em CrossProductFeatures com quantidade de ações fixa.
+		/// @see ia::rl::GDSarsaLambda ia::rl::FixedTileCoding ia::rl::Fixed
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::FixedTileCoding ftc(tc, 4096);
+		/// ia::rl::FixedSarsaLambda agent(&ftc, 3, 0.1, 0.9, 0.95, 0.05, 0.01, true);
+		///
+		/// int a = agent.start(input); // Início do episódio
+		/// while (true) {
+		///		act(a);
+		///		read_inputs(input); // Entradas em Q16.16
+		///		a = agent.step(reward, input, terminal);
+		///		if (terminal) a = agent.start(input);
+		/// }
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class FixedSarsaLambda {
+		private:
+			const FixedTileCoding *m_tc; ///< Parâmetros livres de estado.
+			int m_num_actions; ///< Quantidade de ações.
+			fixed_t m_alpha; ///< Taxa de aprendizagem.
+			fixed_t m_gamma; ///< Fator de desconto.
+			fixed_t m_decay; ///< Decaimento dos traços, \f$ \gamma \lambda \f$.
+			fixed_t m_min_trace; ///< Valor mínimo para um traço continuar ativo.
+			uint32_t m_E; ///< Exploração escalada por \f$ 2^{32} \f$.
+			bool m_replace_traces; ///< Indica se os traços são de substituição ou acumulativos.
+			uint32_t m_rng; ///< Estado do gerador xorshift32.
+
+			std::vector<fixed_t> m_weights; ///< Pesos indexados pelo id do par \f$ (s,a) \f$.
+			std::vector<fixed_t> m_traces; ///< Traços indexados pelo id do par \f$ (s,a) \f$.
+			std::vector<uint8_t> m_is_active; ///< Indica se o id está em m_active.
+			std::vector<int> m_active; ///< Ids com traço ativo.
+
+			std::vector<int> m_curr_ids; ///< Parâmetros livres de estado do estado corrente.
+			std::vector<int> m_next_ids; ///< Parâmetros livres de estado do próximo estado.
+			int m_action; ///< Ação corrente.
+
+			/// Próximo número do gerador xorshift32.
+			uint32_t next_rand() {
+				m_rng ^= m_rng << 13;
+				m_rng ^= m_rng >> 17;
+				m_rng ^= m_rng << 5;
+				return m_rng;
+			}
+
+			/// Calcula \f$ Q(s,a) \f$ a partir dos parâmetros livres de estado.
+			/// @param ids Parâmetros livres de estado.
+			/// @param a Ação.
+			fixed_t value(const int *ids, int a) const;
+
+			/// Escolhe a ação de maior valor **Q**.
+			/// @param ids Parâmetros livres de estado.
+			/// @param q Recebe o valor **Q** da ação escolhida.
+			/// @return Ação escolhida.
+			int best_action(const int *ids, fixed_t &q) const;
+
+			/// Escolhe uma ação seguindo a política E-greedy.
+			/// @param ids Parâmetros livres de estado.
+			/// @param q Recebe o valor **Q** da ação escolhida.
+			/// @return Ação escolhida.
+			int egreedy_action(const int *ids, fixed_t &q);
+
+		public:
+			/// Cria um agente Sarsa Lambda em ponto fixo.
+			/// @param tc Parâmetros livres de estado.
+			/// @param num_actions Quantidade de ações.
+			/// @param alpha Taxa de aprendizagem.
+			/// @param lambda Lambda.
+			/// @param gamma Fator de desconto.
+			/// @param E Exploração.
+			/// @param min_lambda Valor mínimo para um traço continuar ativo.
+			/// @param replace_traces Utiliza traços de substituição ao invés de acumulativos.
+			/// @note Usa ponto flutuante para converter os parâmetros. No microcontrolador, crie uma única vez na configuração.
+			/// @note A memória do FixedTileCoding não é liberada com a destruição de um objeto FixedSarsaLambda.
+			FixedSarsaLambda(const FixedTileCoding *tc, int num_actions, double alpha, double lambda, double gamma, double E,
+			                 double min_lambda, bool replace_traces);
+
+			virtual ~FixedSarsaLambda() { }
+
+			/// Reinicia o gerador de números aleatórios.
+			/// @param seed Semente. Zero é substituído por 1.
+			void seed(uint32_t seed) {
+				m_rng = seed != 0 ? seed : 1;
+			}
+
+			/// Inicia um episódio.
+			///
+			/// Descarta os traços de elegibilidade e escolhe a primeira ação.
+			/// @param input Entrada do estado inicial em Q16.16.
+			/// @return Ação escolhida.
+			int start(const fixed_t *input);
+
+			/// Aprende com uma transição e escolhe a próxima ação.
+			/// @param r Recompensa recebida ao executar a última ação, em Q16.16.
+			/// @param next_input Entrada do próximo estado em Q16.16.
+			/// @param terminal Indica se o próximo estado é terminal. Nesse caso, chame start() para iniciar outro episódio.
+			/// @return Próxima ação.
+			int step(fixed_t r, const fixed_t *next_input, bool terminal);
+
+			/// Calcula \f$ Q(s,a) \f$.
+			/// @param input Entrada do estado em Q16.16.
+			/// @param a Ação.
+			/// @return Valor **Q** em Q16.16.
+			fixed_t q(const fixed_t *input, int a);
+
+			/// Escolhe a ação de maior valor **Q**, sem exploração.
+			/// @param input Entrada do estado em Q16.16.
+			/// @return Ação escolhida.
+			int greedy_action(const fixed_t *input);
+
+			/// Pesos indexados pelo id do par \f$ (s,a) \f$, em Q16.16.
+			const std::vector<fixed_t> &weights() const {
+				return m_weights;
+			}
+
+			/// Quantidade de traços ativos.
+			int num_traces() const {
+				return m_active.size();
+			}
+		};
+	}
+}
+
+#endif
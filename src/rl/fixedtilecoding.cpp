@@ -0,0 +1,92 @@
+/*
+ fixedtilecoding.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "fixedtilecoding.hpp"
+
+using namespace ia::rl;
+
+fixed_t Fixed::from_double(double v)
+{
+    double scaled = floor(v * ONE + 0.5);
+    if (scaled >= 2147483647.)
+        return INT32_MAX;
+    if (scaled <= -2147483648.)
+        return INT32_MIN;
+    return (fixed_t)scaled;
+}
+
+FixedTileCoding::FixedTileCoding(const TileCoding &tilecoding, int size) : m_dim(0), m_num_tilings(tilecoding.m_tilings.size()), m_size(size)
+{
+    if (m_num_tilings > 0)
+        m_dim = tilecoding.m_tilings[0].m_widths.size();
+    m_offset.assign(m_num_tilings * m_dim, 0);
+    m_recip.assign(m_num_tilings * m_dim, 0);
+    m_shift.assign(m_num_tilings * m_dim, 0);
+    m_mask.assign(m_num_tilings * m_dim, 0);
+
+    for (int t = 0; t < m_num_tilings; t++) {
+        const Tiling &tiling = tilecoding.m_tilings[t];
+        for (int i = 0; i < m_dim; i++) {
+            int k = t * m_dim + i;
+            m_mask[k] = tiling.m_dim_mask[i];
+            if (!m_mask[k])
+                continue;
+            m_offset[k] = Fixed::from_double(tiling.m_offset[i]);
+
+            // largest scale 2^s whose reciprocal still fits in 31 bits, so that
+            // d * recip stays below 2^62; rounding up keeps exact multiples of the width
+            // on the same side of the tile border as the division
+            int s = 46;
+            double recip = ceil(ldexp(1., s) / tiling.m_widths[i]);
+            while (s > 0 && recip >= 2147483648.)
+                recip = ceil(ldexp(1., --s) / tiling.m_widths[i]);
+            m_recip[k] = (int32_t)recip;
+            m_shift[k] = Fixed::FRAC_BITS + s;
+        }
+    }
+}
+
+uint32_t FixedTileCoding::hash(int tiling, const fixed_t *input) const
+{
+    uint32_t h = 0;
+    for (int i = 0; i < m_dim; i++) {
+        int k = tiling * m_dim + i;
+        if (m_mask[k])
+            h = 31 * h + (uint32_t)coord(k, input[i]);
+    }
+    return h;
+}
+
+void FixedTileCoding::features(const fixed_t *input, int *ids) const
+{
+    for (int t = 0; t < m_num_tilings; t++) {
+        uint32_t h = (hash(t, input) ^ ((uint32_t)t * 0x9E3779B9u)) * 2654435761u;
+        h ^= h >> 15;
+        // multiply-shift range reduction avoids a division
+        ids[t] = (int)(((uint64_t)h * (uint32_t)m_size) >> 32);
+    }
+}
+
+void FixedTileCoding::get_tile(int tiling, const fixed_t *input, Tile &tile) const
+{
+    tile.m_tiled_vector.resize(m_dim);
+    for (int i = 0; i < m_dim; i++) {
+        int k = tiling * m_dim + i;
+        tile.m_tiled_vector[i] = m_mask[k] ? coord(k, input[i]) : 0;
+    }
+    tile.m_hash_code = (int)hash(tiling, input);
+}
@@ -0,0 +1,155 @@
+/*
+ fixedtilecoding.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef FIXEDTILECODING_H
+#define FIXEDTILECODING_H
+
+#include "tilecoding.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		typedef int32_t fixed_t; ///< Número em ponto fixo Q16.16: 16 bits inteiros com sinal e 16 bits fracionários.
+
+		/// Operações com números em ponto fixo Q16.16.
+		///
+		/// Representa valores entre -32768 e 32767.99998 com resolução de \f$ 2^{-16} \f$ usando
+		/// somente aritmética inteira, para microcontroladores sem unidade de ponto flutuante.
+		/// @see ia::rl::FixedTileCoding ia::rl::FixedSarsaLambda
+		class Fixed {
+		public:
+			static const int FRAC_BITS = 16; ///< Quantidade de bits fracionários.
+			static const fixed_t ONE = 1 << FRAC_BITS; ///< Valor 1.
+
+			/// Converte um número real, arredondando para o mais próximo e saturando fora do intervalo.
+			/// @note Usa ponto flutuante. No microcontrolador, utilize somente na configuração.
+			static fixed_t from_double(double v);
+
+			/// Converte para número real.
+			static double to_double(fixed_t v) {
+				return v * (1. / ONE);
+			}
+
+			/// Converte um número inteiro.
+			static fixed_t from_int(int v) {
+				return (fixed_t)v * ONE;
+			}
+
+			/// Multiplica dois números arredondando para o mais próximo.
+			static fixed_t mul(fixed_t a, fixed_t b) {
+				return (fixed_t)(((int64_t)a * b + (1 << (FRAC_BITS - 1))) >> FRAC_BITS);
+			}
+
+			/// Multiplica dois números arredondando para baixo.
+			///
+			/// Com **b** menor que ONE, o módulo de um valor positivo sempre diminui, por isso é usada
+			/// no decaimento, que com arredondamento para o mais próximo pararia acima de zero.
+			static fixed_t mul_floor(fixed_t a, fixed_t b) {
+				return (fixed_t)(((int64_t)a * b) >> FRAC_BITS);
+			}
+		};
+
+		/// Versão em ponto fixo de um TileCoding para microcontroladores sem unidade de ponto flutuante.
+		///
+		/// Copia os tilings de um TileCoding configurado e calcula os tiles ativados por uma entrada
+		/// Q16.16 somente com aritmética inteira: a divisão pela largura do tile é substituída pela
+		/// multiplicação por um recíproco pré-calculado com 31 bits de precisão. As coordenadas dos
+		/// tiles são as mesmas do TileCoding, exceto quando a entrada está a menos da resolução do
+		/// Q16.16 da borda de um tile.
+		///
+		/// Em vez de um mapa que cresce sob demanda, cada tile é mapeado por hashing para uma tabela de
+		/// tamanho fixo, como no tile coding original de Sutton, de modo que a memória é toda alocada na
+		/// construção. Colisões são raras quando a tabela é bem maior que a quantidade de tiles visitados.
+		/// @see ia::rl::FixedSarsaLambda ia::rl::TileCoding
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::TileCoding tc; // Configurado como para o LinearFA
+		/// tc.add_tiling(mask, widths, 8);
+		/// ia::rl::FixedTileCoding ftc(tc, 4096); // Tabela com 4096 parâmetros livres de estado
+		/// ia::rl::fixed_t input[2] = { analogRead(A0) * 64, analogRead(A1) * 64 }; // Entradas em Q16.16
+		/// int ids[8];
+		/// ftc.features(input, ids);
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class FixedTileCoding {
+		private:
+			int m_dim; ///< Quantidade de variáveis da entrada.
+			int m_num_tilings; ///< Quantidade de tilings.
+			int m_size; ///< Quantidade de parâmetros livres da tabela.
+
+			// os vetores abaixo são indexados por tiling * m_dim + dimensão
+			std::vector<fixed_t> m_offset; ///< Deslocamento do tiling em Q16.16.
+			std::vector<int32_t> m_recip; ///< Recíproco da largura do tile, escalado por \f$ 2^{m\_shift} \f$.
+			std::vector<uint8_t> m_shift; ///< Deslocamento de bits que desfaz a escala de m_recip e do Q16.16.
+			std::vector<uint8_t> m_mask; ///< Indica as dimensões usadas por cada tiling.
+
+			/// Coordenada do tile em uma dimensão, \f$ \lfloor (x - offset) / width \rfloor \f$.
+			/// @param k Índice tiling * m_dim + dimensão.
+			/// @param x Valor da variável em Q16.16.
+			int coord(int k, fixed_t x) const {
+				int64_t d = (int64_t)x - m_offset[k];
+				return (int)((d * m_recip[k]) >> m_shift[k]);
+			}
+
+			/// Código hash das coordenadas, igual ao de Tile.
+			/// @param tiling Índice do tiling.
+			/// @param input Entrada em Q16.16.
+			uint32_t hash(int tiling, const fixed_t *input) const;
+
+		public:
+			/// Cria a versão em ponto fixo de um TileCoding.
+			/// @param tilecoding TileCoding com os tilings já adicionados.
+			/// @param size Quantidade de parâmetros livres de estado da tabela.
+			/// @note Usa ponto flutuante. No microcontrolador, crie uma única vez na configuração.
+			FixedTileCoding(const TileCoding &tilecoding, int size);
+
+			virtual ~FixedTileCoding() { }
+
+			/// Quantidade de variáveis da entrada.
+			int dim() const {
+				return m_dim;
+			}
+
+			/// Quantidade de tilings e de parâmetros livres ativos por entrada.
+			int num_tilings() const {
+				return m_num_tilings;
+			}
+
+			/// Quantidade de parâmetros livres de estado da tabela.
+			int size() const {
+				return m_size;
+			}
+
+			/// Obtém os parâmetros livres de estado ativados por uma entrada.
+			/// @param input Entrada com dim() variáveis em Q16.16.
+			/// @param ids Recebe num_tilings() ids entre 0 e size() - 1, um por tiling.
+			void features(const fixed_t *input, int *ids) const;
+
+			/// Encontra o tile ativado pela entrada em um tiling.
+			///
+			/// Produz o mesmo Tile que Tiling::get_tile() e serve para comparar esta classe com o TileCoding.
+			/// @param tiling Índice do tiling.
+			/// @param input Entrada com dim() variáveis em Q16.16.
+			/// @param tile Tile que recebe a localização do tile ativado pela entrada.
+			void get_tile(int tiling, const fixed_t *input, Tile &tile) const;
+		};
+	}
+}
+
+#endif
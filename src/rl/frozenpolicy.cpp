@@ -0,0 +1,109 @@
+/*
+ frozenpolicy.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "frozenpolicy.hpp"
+
+#include <math.h>
+#include <string.h>
+
+using namespace ia::rl;
+
+FrozenPolicy::FrozenPolicy() : m_header(nullptr), m_actions(nullptr), m_cell_base(nullptr), m_dims(nullptr), m_weights(nullptr) {}
+
+bool FrozenPolicy::open(const void *data, size_t length)
+{
+    m_header = nullptr;
+    const FrozenPolicyHeader *h = (const FrozenPolicyHeader *)data;
+    if (length < sizeof(FrozenPolicyHeader) || memcmp(h->m_magic, "DTFP", 4) != 0 || h->m_version != FrozenPolicyHeader::VERSION ||
+        h->m_dim < 0 || h->m_num_tilings < 0 || h->m_num_actions <= 0 || h->m_num_actions > MAX_ACTIONS || h->m_num_cells < 0)
+        return false;
+
+    uint64_t words = (uint64_t)h->m_num_actions + h->m_num_tilings + (uint64_t)h->m_num_tilings * h->m_dim * 5 +
+                     (uint64_t)h->m_num_cells * h->m_num_actions;
+    if (sizeof(FrozenPolicyHeader) + words * 4 > length)
+        return false;
+
+    const char *p = (const char *)data + sizeof(FrozenPolicyHeader);
+    const int32_t *actions = (const int32_t *)p;
+    const int32_t *cell_base = actions + h->m_num_actions;
+    const FrozenDim *dims = (const FrozenDim *)(cell_base + h->m_num_tilings);
+
+    // every cell reachable by cell() must lie inside the weight table
+    for (int t = 0; t < h->m_num_tilings; t++) {
+        int64_t last = cell_base[t];
+        if (last < 0)
+            return false;
+        for (int i = 0; i < h->m_dim; i++) {
+            const FrozenDim &d = dims[t * h->m_dim + i];
+            if (d.m_extent < 0 || d.m_stride < 0 || !isfinite(d.m_offset) || !isfinite(d.m_inv_width))
+                return false;
+            if (d.m_extent > 0)
+                last += (int64_t)(d.m_extent - 1) * d.m_stride;
+            if (last >= h->m_num_cells)
+                return false;
+        }
+        if (last >= h->m_num_cells)
+            return false;
+    }
+
+    m_actions = actions;
+    m_cell_base = cell_base;
+    m_dims = dims;
+    m_weights = (const float *)(m_dims + h->m_num_tilings * h->m_dim);
+    m_header = h;
+    return true;
+}
+
+int FrozenPolicy::cell(int tiling, const float *input) const
+{
+    const FrozenDim *dims = m_dims + tiling * m_header->m_dim;
+    int c = m_cell_base[tiling];
+    for (int i = 0; i < m_header->m_dim; i++) {
+        int coord = (int)floorf((input[i] - dims[i].m_offset) * dims[i].m_inv_width) - dims[i].m_min;
+        if (coord < 0 || coord >= dims[i].m_extent)
+            return -1;
+        c += coord * dims[i].m_stride;
+    }
+    return c;
+}
+
+void FrozenPolicy::values(const float *input, float *q) const
+{
+    int na = m_header->m_num_actions;
+    for (int a = 0; a < na; a++)
+        q[a] = 0.f;
+    for (int t = 0; t < m_header->m_num_tilings; t++) {
+        int c = cell(t, input);
+        if (c < 0)
+            continue;
+        const float *w = m_weights + (size_t)c * na;
+        for (int a = 0; a < na; a++)
+            q[a] += w[a];
+    }
+}
+
+int FrozenPolicy::greedy_action(const float *input) const
+{
+    float q[MAX_ACTIONS];
+    values(input, q);
+    int best = 0;
+    for (int a = 1; a < m_header->m_num_actions; a++) {
+        if (q[a] > q[best])
+            best = a;
+    }
+    return m_actions[best];
+}
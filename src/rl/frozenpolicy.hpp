@@ -0,0 +1,142 @@
+/*
+ frozenpolicy.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef FROZENPOLICY_H
+#define FROZENPOLICY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ia {
+	namespace rl {
+		/// Cabeçalho de uma política congelada gerada por PolicyCompiler.
+		///
+		/// Todos os campos e seções têm 4 bytes por elemento, de modo que a política pode ser
+		/// embutida como um vetor de uint32_t. Após o cabeçalho, seguem as seções:
+		/// - números das ações (int32_t), na ordem usada pelos pesos;
+		/// - primeira célula de cada tiling na tabela de pesos (int32_t);
+		/// - FrozenDim de cada dimensão de cada tiling;
+		/// - pesos (float) de cada célula, com os pesos das ações de uma célula contíguos.
+		///
+		/// Os números são gravados na ordem de bytes da máquina que gerou a política.
+		/// @see ia::rl::FrozenPolicy ia::rl::PolicyCompiler
+		struct FrozenPolicyHeader {
+			char m_magic[4]; ///< Identificação: "DTFP".
+			uint32_t m_version; ///< Versão do formato.
+			int32_t m_dim; ///< Quantidade de variáveis de um estado.
+			int32_t m_num_tilings; ///< Quantidade de tilings.
+			int32_t m_num_actions; ///< Quantidade de ações.
+			int32_t m_num_cells; ///< Quantidade total de células da tabela de pesos.
+
+			static const uint32_t VERSION = 1; ///< Versão atual do formato.
+		};
+
+		/// Dimensão de um tiling de uma política congelada.
+		///
+		/// A coordenada do tile é \f$ \lfloor (x - offset) \cdot inv\_width \rfloor - min \f$, válida
+		/// entre 0 e extent - 1. Dimensões fora da máscara do tiling têm inv_width 0 e extent 1.
+		struct FrozenDim {
+			float m_offset; ///< Deslocamento do tiling.
+			float m_inv_width; ///< Inverso da largura do tile.
+			int32_t m_min; ///< Menor coordenada visitada durante o treinamento.
+			int32_t m_extent; ///< Quantidade de coordenadas entre a menor e a maior visitada.
+			int32_t m_stride; ///< Distância, em células, entre coordenadas vizinhas.
+		};
+
+		/// Avaliador de uma política gulosa congelada por PolicyCompiler.
+		///
+		/// Lê a política diretamente da memória, sem copiá-la e sem alocar memória, de modo que ela
+		/// pode ficar na flash do microcontrolador como um vetor gerado por PolicyCompiler::save_header().
+		/// @note A política só permanece na flash em microcontroladores que mapeiam a flash no espaço de
+		/// endereços, como Cortex-M, ESP32 e RP2040. No AVR, um vetor **const** é copiado para a RAM
+		/// na inicialização e FrozenPolicy não lê vetores PROGMEM.
+		/// Cada tiling contribui com uma única célula da tabela densa de pesos, por isso
+		/// greedy_action() custa somente num_tilings acessos de num_actions pesos contíguos.
+		/// @see ia::rl::PolicyCompiler ia::rl::FrozenPolicyHeader
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// #include "motor_policy.h" // Gerado por ia::rl::PolicyCompiler::save_header()
+		///
+		/// ia::rl::FrozenPolicy policy;
+		/// policy.open(motor_policy, sizeof(motor_policy));
+		/// float input[2] = { speed, angle };
+		/// int a = policy.greedy_action(input); // Número da ação
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class FrozenPolicy {
+		private:
+			const FrozenPolicyHeader *m_header; ///< Cabeçalho.
+			const int32_t *m_actions; ///< Número de cada ação.
+			const int32_t *m_cell_base; ///< Primeira célula de cada tiling.
+			const FrozenDim *m_dims; ///< Dimensões de cada tiling.
+			const float *m_weights; ///< Pesos de cada célula e ação.
+
+		public:
+			static const int MAX_ACTIONS = 64; ///< Quantidade máxima de ações.
+
+			/// Cria um avaliador sem nenhuma política.
+			FrozenPolicy();
+
+			virtual ~FrozenPolicy() { }
+
+			/// Associa uma política congelada ao avaliador.
+			/// @param data Política, alinhada em 4 bytes. Deve continuar válida enquanto for avaliada.
+			/// @param length Tamanho da política em bytes.
+			/// @return **True** se a política é válida ou **false**, caso contrário. Além do tamanho, são
+			/// verificadas as dimensões de cada tiling, de modo que nenhuma célula fique fora da tabela de pesos.
+			bool open(const void *data, size_t length);
+
+			/// Indica se há uma política associada.
+			bool is_open() const {
+				return m_header != nullptr;
+			}
+
+			/// Quantidade de variáveis de um estado.
+			int dim() const {
+				return m_header->m_dim;
+			}
+
+			/// Quantidade de ações.
+			int num_actions() const {
+				return m_header->m_num_actions;
+			}
+
+			/// Número da ação de índice **i**, igual a Action::m_num.
+			int action(int i) const {
+				return m_actions[i];
+			}
+
+			/// Encontra a célula ativada pela entrada em um tiling.
+			/// @param tiling Índice do tiling.
+			/// @param input Entrada com dim() variáveis.
+			/// @return Índice da célula ou -1, caso o tile não tenha sido visitado no treinamento.
+			int cell(int tiling, const float *input) const;
+
+			/// Calcula os valores **Q** de todas as ações.
+			/// @param input Entrada com dim() variáveis.
+			/// @param q Recebe num_actions() valores, na ordem de action().
+			void values(const float *input, float *q) const;
+
+			/// Escolhe a ação de maior valor **Q**.
+			/// @param input Entrada com dim() variáveis.
+			/// @return Número da ação, igual a Action::m_num.
+			int greedy_action(const float *input) const;
+		};
+	}
+}
+
+#endif
@@ -20,94 +20,131 @@
 using namespace ia::rl;
 
 GDSarsaLambda::GDSarsaLambda(double alpha, double lambda, double gamma, double E, double min_lambda, bool replace_traces, LinearFA *vfa) :
-    m_alpha(alpha), m_lambda(lambda), m_gamma(gamma), m_E(E), m_min_lambda(min_lambda), m_replace_traces(replace_traces),
-    m_vfa(vfa), m_distribution(0, 1) {}
+    m_policy_worker(Rng(1)), m_vfa(vfa), m_alpha(alpha), m_lambda(lambda), m_gamma(gamma), m_E(E), m_min_lambda(min_lambda),
+    m_replace_traces(replace_traces), m_curr_step(0), m_replay(nullptr), m_sink(nullptr), m_planning_steps(0) {}
+
+void GDSarsaLambda::seed(uint64_t seed)
+{
+    m_learner.m_rng.seed(seed);
+}
 
 Episode *GDSarsaLambda::run_learning(Env *env, int max_steps)
 {
     State *curr_s = env->curr_obs();
-    Episode *ea = new Episode(curr_s);
+    Episode *ea = m_sink != nullptr ? new Episode() : new Episode(curr_s);
+    ea->m_owns_states = !env->pooled_states();
+    if (m_sink != nullptr)
+        m_sink->begin_episode(*curr_s);
 
     m_curr_step = 0;
-    std::map<int, double> traces;
-    std::vector<int> delete_traces;
+    m_learner.m_traces.clear();
+    if (m_replay != nullptr && m_planning_steps > 0)
+        m_env_actions = env->action_list();
 
     Action *action = egreedy_action(env, curr_s);
     while (!env->is_terminal() && (m_curr_step < max_steps || max_steps == -1)) {
-        // get Q-value and gradient
-        double curr_Q = m_vfa->evaluate(*curr_s, *action);
-        std::map<int, double> gradient = m_vfa->gradient(curr_s, action);
-
-        EnvOutcome *eo = env->exec_act(action);
-        State *next_s = eo->m_op;
+        double curr_Q = begin_step(curr_s, action, m_learner);
 
-        // determine next Q-value for outcome state
+        StepOutcome eo = env->step(action);
+        State *next_s = eo.m_op;
         Action *next_a = egreedy_action(env, next_s);
-        double next_Q = 0.;
-        if (!eo->m_terminated)
-            next_Q = m_vfa->evaluate(*next_s, *next_a);
 
         // manage option specifics
-        double r = eo->m_r;
+        double r = eo.m_r;
         m_curr_step++;
-        ea->transition(action, next_s, r);
-
-        // compute function delta
-        double delta = r + (m_gamma * next_Q) - curr_Q;
-
-        // manage traces
-        std::map<int, double> ofg = m_vfa->gradient(curr_s, action);
-        for (std::map<int, double>::iterator it = ofg.begin(); it != ofg.end(); ++it) {
-            if (m_replace_traces)
-                traces[it->first] = 1.;
-            else
-                traces[it->first] += 1;
-        }
-
-        for (std::map<int, double>::iterator it = traces.begin(); it != traces.end(); ++it) {
-            m_vfa->m_weights[it->first] = m_vfa->get_weight(it->first) + m_alpha * delta * traces[it->first];
-            // now decay and delete from tracking if too small
-            traces[it->first] *= m_lambda * m_gamma;
-            if (traces[it->first] < m_min_lambda)
-                delete_traces.push_back(it->first);
-        }
-
-        // delete traces marked for deletion
-        for (int i : delete_traces)
-            traces.erase(i);
+        if (m_sink != nullptr)
+            m_sink->transition(*action, r, *next_s, eo.m_terminated);
+        else
+            ea->transition(action, next_s, r);
+        if (m_replay != nullptr)
+            m_replay->add(*curr_s, *action, r, *next_s, eo.m_terminated, &m_learner.m_mask);
+
+        end_step(eo, next_a, curr_Q, m_learner);
+
+        // planning updates with simulated transitions
+        if (m_replay != nullptr && m_planning_steps > 0)
+            m_replay->replay(*m_vfa, m_env_actions, m_planning_steps, m_alpha, m_gamma);
 
         // move on
+        if (m_sink != nullptr)
+            env->release_state(curr_s);
         curr_s = next_s;
         action = next_a;
     }
 
+    if (m_sink != nullptr) {
+        env->release_state(curr_s);
+        m_sink->end_episode();
+    }
     return ea;
 }
 
+double GDSarsaLambda::run_policy(Env *env, int max_steps, PolicyStats *stats, double E)
+{
+    PolicyEvaluator evaluator(m_vfa, E);
+    return evaluator.run_policy(env, max_steps, stats, m_policy_worker);
+}
+
 Action *GDSarsaLambda::egreedy_action(Env *env, State *curr_s)
 {
-    std::vector<Action *> actions = env->applicable_actions(curr_s);
-    Action *best = greedy_action(env, curr_s);
-    if (m_distribution(m_gen) > m_E)
-        return best;
+    return egreedy_action(env, curr_s, m_learner);
+}
+
+Action *GDSarsaLambda::egreedy_action(Env *env, State *curr_s, Learner &l)
+{
+    env->applicable_actions(curr_s, l.m_mask, l.m_actions);
+    if (l.m_rng.uniform() >= m_E)
+        return best_action(curr_s, l);
     else
-    {
-        int rnd_a = round((actions.size() - 1) * m_distribution(m_gen));
-        return actions[rnd_a];
-    }
+        return l.m_actions[l.m_rng.uniform_int(l.m_actions.size())];
 }
 
 Action *GDSarsaLambda::greedy_action(Env *env, State *curr_s)
 {
-    std::vector<Action *> actions = env->applicable_actions(curr_s);
-    Action *best = actions[0];
-    double vsa = m_vfa->evaluate(*curr_s, *best);
-    for (Action *a : actions) {
-        double v = m_vfa->evaluate(*curr_s, *a);
-        if (v > vsa) {
-            best = a;
-            vsa = v;
-        }
+    env->applicable_actions(curr_s, m_learner.m_mask, m_learner.m_actions);
+    return best_action(curr_s, m_learner);
+}
+
+Action *GDSarsaLambda::best_action(State *curr_s, Learner &l)
+{
+    m_vfa->evaluate_all(*curr_s, l.m_actions, l.m_q, l.m_work);
+    int best = 0;
+    for (int i = 1; i < l.m_q.size(); i++) {
+        if (l.m_q[i] > l.m_q[best])
+            best = i;
+    }
+    return l.m_actions[best];
+}
+
+double GDSarsaLambda::begin_step(State *curr_s, Action *action, Learner &l)
+{
+    // get Q-value and gradient
+    m_vfa->features(curr_s, action, l.m_features);
+    double curr_Q = m_vfa->evaluate(l.m_features);
+
+    // manage traces
+    for (const StateFeature &sf : l.m_features) {
+        if (m_replace_traces)
+            l.m_traces.replace(sf.m_id, sf.m_value);
+        else
+            l.m_traces.accumulate(sf.m_id, sf.m_value);
     }
-    return best;
+    return curr_Q;
+}
+
+double GDSarsaLambda::end_step(const StepOutcome &eo, Action *next_a, double curr_Q, Learner &l)
+{
+    // determine next Q-value for outcome state
+    double next_Q = 0.;
+    if (!eo.m_terminated) {
+        m_vfa->features(eo.m_op, next_a, l.m_features);
+        next_Q = m_vfa->evaluate(l.m_features);
+    }
+
+    // compute function delta
+    double delta = eo.m_r + (m_gamma * next_Q) - curr_Q;
+
+    // update weights, then decay and delete from tracking if too small
+    l.m_traces.update(*m_vfa, m_alpha * delta, m_lambda * m_gamma, m_min_lambda);
+    return delta;
 }
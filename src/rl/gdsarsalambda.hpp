@@ -19,10 +19,14 @@
 #define GDSARSALAMBDA_H
 
 #include "linearfa.hpp"
+#include "eligibilitytraces.hpp"
+#include "replaybuffer.hpp"
+#include "policyevaluator.hpp"
 #include "episode.hpp"
+#include "episodesink.hpp"
 #include "env.hpp"
 
-#include <random>
+#include "rng.hpp"
 
 namespace ia {
 	namespace rl {
@@ -46,9 +50,36 @@ namespace ia {
     	/// ia::rl::Episode e = gdsl.run_learning(env, 100); // Inicia aprendizagem de 1 episódio
         /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 		class GDSarsaLambda {
-		private:
-			std::default_random_engine m_gen; ///< Gerador de números aleatórios.
-			std::uniform_real_distribution<float> m_distribution; ///< Distribuição uniforme entre 0 e 1.
+		public:
+			/// Estado privado de um agente que executa os passos de aprendizagem de um GDSarsaLambda.
+			///
+			/// Cada thread que aprende sobre o mesmo LinearFA utiliza seu próprio Learner.
+			/// @see begin_step() end_step() ia::rl::Hogwild ia::rl::VecEnv
+			class Learner {
+			public:
+				Rng m_rng; ///< Gerador de números aleatórios da política E-greedy.
+				ActionMask m_mask; ///< Máscara das ações realizáveis na última seleção de ação.
+				std::vector<Action *> m_actions; ///< Ações realizáveis consultadas na última seleção de ação.
+				std::vector<double> m_q; ///< Valores **Q** das ações em m_actions.
+				EligibilityTraces m_traces; ///< Traços de elegibilidade do episódio corrente.
+				std::vector<StateFeature> m_features; ///< Parâmetros livres do par \f$ (s,a) \f$ corrente.
+				std::vector<StateFeature> m_work; ///< Vetor de trabalho de LinearFA::evaluate_all().
+
+				Learner() { }
+
+				Learner(const Rng &rng) : m_rng(rng) { }
+			};
+
+		protected:
+			Learner m_learner; ///< Estado do agente usado por run_learning().
+			std::vector<Action *> m_env_actions; ///< Todas as ações do ambiente, usadas no planejamento.
+			PolicyEvaluator::Worker m_policy_worker; ///< Vetores de trabalho de run_policy().
+
+			/// Encontra a melhor ação dentre as ações já armazenadas em Learner::m_actions.
+			/// @param curr_s Estado do ambiente.
+			/// @param l Agente.
+			/// @return Melhor ação **a** de acordo com a estimativa atual de \f$ Q(s,a) \f$.
+			Action *best_action(State *curr_s, Learner &l);
 
 		public:
 			LinearFA *m_vfa; ///< Aproximador de funções linear.
@@ -62,6 +93,20 @@ namespace ia {
 
 			int m_curr_step; ///< Passo de tempo corrente
 
+			/// Buffer que recebe as transições executadas por run_learning() ou nullptr para não gravá-las.
+			/// @see ia::rl::ReplayBuffer
+			ReplayBuffer *m_replay;
+			/// Destino das transições executadas por run_learning() ou nullptr para acumulá-las no Episode.
+			///
+			/// Quando atribuído, o Episode retornado por run_learning() não contém nenhum estado e os
+			/// estados são liberados pelo agente assim que deixam de ser utilizados.
+			/// @see ia::rl::EpisodeSink ia::rl::TrajectoryWriter
+			EpisodeSink *m_sink;
+			/// Atualizações simuladas com transições de m_replay executadas após cada passo real.
+			/// @note Ignorado por TrueOnlineSarsaLambda.
+			/// @see ia::rl::DynaModel
+			int m_planning_steps;
+
 			/// Cria um agente Sarsa Lambda de aprendizagem por reforço.
 			/// @param alpha Taxa de aprendizagem.
 			/// @param lambda Taxa de decaimento.
@@ -84,7 +129,28 @@ namespace ia {
 			/// @see ia::rl::Episode ia::rl::Env
 			/// @note O ambiente não é reiniciado após o fim do episódio por esta função. Chame manualmente a 
 			/// função ia::rl::Env::reset_env() antes de chamar run_learning() novamente, caso necessário.
-			Episode *run_learning(Env *env, int max_steps);
+			virtual Episode *run_learning(Env *env, int max_steps);
+
+			/// Executa a política aprendida em um episódio sem aprendizagem.
+			///
+			/// Nenhum peso ou parâmetro livre é criado ou modificado e nenhum Episode é criado.
+			/// @param env Ambiente de aprendizagem por reforço. Não é reiniciado por esta função.
+			/// @param max_steps Número máximo de passos permitidos no episódio ou -1 para não limitar.
+			/// @param stats Recebe o retorno e o número de passos do episódio. Pode ser nullptr.
+			/// @param E Exploração. Utilize 0 para a política gulosa.
+			/// @return Soma das recompensas recebidas.
+			/// @see ia::rl::PolicyEvaluator
+			double run_policy(Env *env, int max_steps, PolicyStats *stats, double E);
+
+			/// Reinicia o gerador de números aleatórios do agente.
+			/// @param seed Semente.
+			void seed(uint64_t seed);
+
+			/// Gerador de números aleatórios do agente.
+			/// @return Gerador usado pelo agente e base das sequências de Hogwild.
+			const Rng &rng() const {
+				return m_learner.m_rng;
+			}
 
 			/// Retorna uma ação seguindo uma política E-greedy.
 			/// @param env Ambiente de aprendizagem por reforço.
@@ -98,6 +164,32 @@ namespace ia {
 			/// @param curr_s Estado do ambiente.
 			/// @return Melhor ação **a** de acordo com a estimativa atual de \f$ Q(s,a) \f$;
 			Action *greedy_action(Env *env, State *curr_s);
+
+			/// Retorna uma ação seguindo uma política E-greedy com o estado de um agente externo.
+			///
+			/// Pode ser chamada por várias threads ao mesmo tempo quando LinearFA::set_concurrent() está
+			/// habilitado, desde que cada thread utilize seu próprio Learner.
+			/// @param env Ambiente de aprendizagem por reforço.
+			/// @param curr_s Estado do ambiente.
+			/// @param l Agente.
+			/// @return Ação escolhida.
+			Action *egreedy_action(Env *env, State *curr_s, Learner &l);
+
+			/// Inicia um passo de aprendizagem: calcula \f$ Q(s,a) \f$ e atualiza os traços do agente.
+			/// @param curr_s Estado **s** do passo.
+			/// @param action Ação **a** executada no passo.
+			/// @param l Agente.
+			/// @return Valor \f$ Q(s,a) \f$.
+			/// @see end_step()
+			double begin_step(State *curr_s, Action *action, Learner &l);
+
+			/// Encerra um passo de aprendizagem: calcula o erro TD e atualiza os pesos pelos traços do agente.
+			/// @param eo Resultado do passo.
+			/// @param next_a Próxima ação escolhida para o estado eo.m_op.
+			/// @param curr_Q Valor retornado por begin_step().
+			/// @param l Agente.
+			/// @return Erro TD do passo.
+			double end_step(const StepOutcome &eo, Action *next_a, double curr_Q, Learner &l);
 		};
 	}
 }
@@ -0,0 +1,73 @@
+/*
+ hogwild.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "hogwild.hpp"
+
+#include <thread>
+
+using namespace ia::rl;
+
+Hogwild::Hogwild(std::vector<Env *> envs, GDSarsaLambda *agent, int max_params) : m_agent(agent)
+{
+    for (int i = 0; i < envs.size(); i++)
+        m_workers.push_back(Worker(envs[i], agent->rng().stream(i + 1)));
+    m_agent->m_vfa->set_concurrent(true, max_params);
+}
+
+void Hogwild::run_learner(Worker &w, int num_episodes, int max_steps)
+{
+    GDSarsaLambda::Learner &l = w.m_learner;
+    for (int e = 0; e < num_episodes; e++) {
+        w.m_env->reset_env();
+        l.m_traces.clear();
+        State *curr_s = w.m_env->curr_obs();
+        Action *action = m_agent->egreedy_action(w.m_env, curr_s, l);
+        double ret = 0.;
+        int step = 0;
+
+        while (!w.m_env->is_terminal() && (step < max_steps || max_steps == -1)) {
+            double curr_Q = m_agent->begin_step(curr_s, action, l);
+            StepOutcome eo = w.m_env->step(action);
+            Action *next_a = m_agent->egreedy_action(w.m_env, eo.m_op, l);
+            m_agent->end_step(eo, next_a, curr_Q, l);
+
+            ret += eo.m_r;
+            step++;
+            w.m_env->release_state(curr_s);
+            curr_s = eo.m_op;
+            action = next_a;
+        }
+        w.m_env->release_state(curr_s);
+        w.m_episode_returns.push_back(ret);
+    }
+}
+
+int Hogwild::run_learning(int num_episodes, int max_steps)
+{
+    std::vector<std::thread> threads;
+    for (Worker &w : m_workers) {
+        w.m_episode_returns.clear();
+        threads.push_back(std::thread(&Hogwild::run_learner, this, std::ref(w), num_episodes, max_steps));
+    }
+    for (std::thread &t : threads)
+        t.join();
+
+    m_episode_returns.clear();
+    for (Worker &w : m_workers)
+        m_episode_returns.insert(m_episode_returns.end(), w.m_episode_returns.begin(), w.m_episode_returns.end());
+    return m_episode_returns.size();
+}
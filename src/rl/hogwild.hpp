@@ -0,0 +1,91 @@
+/*
+ hogwild.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef HOGWILD_H
+#define HOGWILD_H
+
+#include "gdsarsalambda.hpp"
+#include "env.hpp"
+
+#include <vector>
+#include "rng.hpp"
+
+namespace ia {
+	namespace rl {
+		/// Treinamento assíncrono de vários agentes Sarsa Lambda sobre um único LinearFA (Hogwild).
+		///
+		/// Cada agente roda em sua própria thread, com seu próprio ambiente e GDSarsaLambda::Learner,
+		/// e executa os passos de GDSarsaLambda::begin_step() e GDSarsaLambda::end_step(), que
+		/// atualizam os pesos compartilhados sem nenhuma trava.
+		/// Como os parâmetros livres do TileCoding são esparsos, conflitos entre as atualizações
+		/// são raros. Somente a criação de novos parâmetros livres é sincronizada.
+		/// @see ia::rl::GDSarsaLambda ia::rl::LinearFA::set_concurrent()
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// std::vector<ia::rl::Env *> envs { new ..., new ..., new ..., new ... }; // Um ambiente por thread
+		/// ia::rl::GDSarsaLambda gdsl(0.1, 0.9, 0.95, 0.1, 0.01, true, &fa); // Parâmetros de aprendizagem
+		/// ia::rl::Hogwild hw(envs, &gdsl, 100000); // Reserva 100000 pesos
+		/// hw.run_learning(500, 100); // 500 episódios em cada thread
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class Hogwild {
+		private:
+			/// Estado privado de cada agente.
+			class Worker {
+			public:
+				Env *m_env; ///< Ambiente do agente.
+				GDSarsaLambda::Learner m_learner; ///< Traços, vetores de trabalho e números aleatórios do agente.
+				std::vector<double> m_episode_returns; ///< Retorno de cada episódio encerrado.
+
+				Worker(Env *env, const Rng &rng) : m_env(env), m_learner(rng) { }
+			};
+
+			std::vector<Worker> m_workers; ///< Agentes.
+			GDSarsaLambda *m_agent; ///< Parâmetros de aprendizagem e LinearFA compartilhado.
+
+			/// Executa episódios de aprendizagem de um agente.
+			/// @param w Agente.
+			/// @param num_episodes Número de episódios.
+			/// @param max_steps Número máximo de passos de um episódio ou -1 para não limitar.
+			void run_learner(Worker &w, int num_episodes, int max_steps);
+
+		public:
+			std::vector<double> m_episode_returns; ///< Retorno dos episódios encerrados na última chamada a run_learning().
+
+			/// Cria um treinamento Hogwild.
+			/// @param envs Ambientes. Um agente é criado para cada ambiente.
+			/// @param agent Agente com os parâmetros de aprendizagem e o LinearFA compartilhado.
+			/// @param max_params Quantidade de pesos reservados no LinearFA. Atualizações de ids maiores são
+			/// descartadas e contadas por LinearFA::dropped_updates().
+			/// @see ia::rl::LinearFA::set_concurrent()
+			/// @note A memória dos ambientes e do agente não é liberada com a destruição de um objeto Hogwild.
+			Hogwild(std::vector<Env *> envs, GDSarsaLambda *agent, int max_params);
+
+			virtual ~Hogwild() { }
+
+			/// Executa episódios de aprendizagem em todos os agentes ao mesmo tempo.
+			///
+			/// Cada ambiente é reiniciado com Env::reset_env() antes de cada episódio.
+			/// @param num_episodes Número de episódios executados por cada agente.
+			/// @param max_steps Número máximo de passos de um episódio ou -1 para não limitar.
+			/// @return Quantidade total de episódios encerrados.
+			int run_learning(int num_episodes, int max_steps);
+		};
+	}
+}
+
+#endif
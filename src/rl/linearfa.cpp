@@ -35,79 +35,278 @@ int FeaturesMap::get_or_create(int from, int &feature_id)
     return to;
 }
 
+int FeaturesMap::find(int from) const
+{
+    auto it = m_features_map.find(from);
+    if (it == m_features_map.end())
+        return -1;
+    return it->second;
+}
+
 int CrossProductFeatures::action_feature(Action &a, int from)
 {
-    return m_action_features[a.m_num].get_or_create(from, m_feature_id);
+    if (m_num_actions > 0) {
+        int to = from * m_num_actions + a.m_num;
+        if (to >= m_feature_id)
+            m_feature_id = to + 1;
+        return to;
+    }
+    int before = m_feature_id;
+    int to = m_action_features[a.m_num].get_or_create(from, m_feature_id);
+    if (m_track_new && m_feature_id != before) {
+        m_new_pairs.push_back(a.m_num);
+        m_new_pairs.push_back(from);
+        m_new_pairs.push_back(to);
+    }
+    return to;
 }
 
-CrossProductFeatures::CrossProductFeatures(TileCoding sfeatures) : m_sfeatures(sfeatures), m_feature_id(0) {}
+CrossProductFeatures::CrossProductFeatures(TileCoding sfeatures) : m_sfeatures(sfeatures), m_feature_id(0), m_num_actions(0), m_track_new(false) {}
+
+CrossProductFeatures::CrossProductFeatures(TileCoding sfeatures, int num_actions) : m_sfeatures(sfeatures), m_feature_id(0), m_num_actions(num_actions),
+                                                                                      m_track_new(false) {}
 
 CrossProductFeatures::CrossProductFeatures(const CrossProductFeatures &cross_pfeatures) : m_sfeatures(cross_pfeatures.m_sfeatures), m_action_features(cross_pfeatures.m_action_features),
-                                                                                          m_feature_id(cross_pfeatures.m_feature_id) {}
+                                                                                          m_feature_id(cross_pfeatures.m_feature_id), m_num_actions(cross_pfeatures.m_num_actions),
+                                                                                          m_track_new(false) {}
 
 std::vector<StateFeature> CrossProductFeatures::features(State *s, Action &a)
 {
-    std::vector<StateFeature> sfs = m_sfeatures.features(s);
     std::vector<StateFeature> safs;
-    safs.reserve(sfs.size());
+    features(s, a, safs);
+    return safs;
+}
+
+void CrossProductFeatures::features(State *s, Action &a, std::vector<StateFeature> &features)
+{
+    m_sfeatures.features(s, features);
+    for (StateFeature &sf : features)
+        sf.m_id = action_feature(a, sf.m_id);
+}
+
+std::vector<StateFeature> CrossProductFeatures::state_features(State *s)
+{
+    return m_sfeatures.features(s);
+}
 
-    for (StateFeature sf : sfs) {
-        StateFeature saf(action_feature(a, sf.m_id), sf.m_value);
-        safs.push_back(saf);
+void CrossProductFeatures::state_features(State *s, std::vector<StateFeature> &features)
+{
+    m_sfeatures.features(s, features);
+}
+
+void CrossProductFeatures::find_state_features(const std::vector<double> &input, Tile &tile, std::vector<StateFeature> &features) const
+{
+    m_sfeatures.find_features(input, tile, features);
+}
+
+int CrossProductFeatures::find_action_feature(const Action &a, int from) const
+{
+    if (m_num_actions > 0)
+        return from * m_num_actions + a.m_num;
+    auto it = m_action_features.find(a.m_num);
+    if (it == m_action_features.end())
+        return -1;
+    return it->second.find(from);
+}
+
+void CrossProductFeatures::take_recycled(std::vector<int> &ids)
+{
+    m_sfeatures.take_recycled(m_recycled_states);
+    ids.clear();
+    for (int from : m_recycled_states) {
+        if (m_num_actions > 0) {
+            for (int a = 0; a < m_num_actions; a++)
+                ids.push_back(from * m_num_actions + a);
+        }
+        else {
+            for (auto &entry : m_action_features) {
+                int to = entry.second.find(from);
+                if (to >= 0)
+                    ids.push_back(to);
+            }
+        }
     }
-    return safs;
 }
 
 int CrossProductFeatures::num_features()
 {
+    if (m_num_actions > 0)
+        return m_sfeatures.num_features() * m_num_actions;
     return m_sfeatures.num_features() * m_feature_id;
 }
 
-LinearFA::LinearFA() : m_safeatures(TileCoding()), m_default_weight(0) {}
+LinearFA::LinearFA() : m_last_state(nullptr), m_last_action(nullptr), m_safeatures(TileCoding()), m_default_weight(0), m_track_dirty(false),
+                       m_trace_precision(WeightVector::DOUBLE) {}
+
+LinearFA::LinearFA(TileCoding tilecoding) : m_last_state(nullptr), m_last_action(nullptr), m_safeatures(tilecoding), m_default_weight(0.),
+                                            m_track_dirty(false), m_trace_precision(WeightVector::DOUBLE) {}
 
-LinearFA::LinearFA(TileCoding tilecoding) : m_safeatures(tilecoding), m_default_weight(0.) {}
+LinearFA::LinearFA(TileCoding tilecoding, double default_weight) : m_last_state(nullptr), m_last_action(nullptr), m_safeatures(tilecoding),
+                                                                   m_default_weight(default_weight), m_track_dirty(false),
+                                                                   m_trace_precision(WeightVector::DOUBLE) {}
 
-LinearFA::LinearFA(TileCoding tilecoding, double default_weight) : m_safeatures(tilecoding), m_default_weight(default_weight) {}
+LinearFA::LinearFA(TileCoding tilecoding, double default_weight, int num_actions) : m_last_state(nullptr), m_last_action(nullptr),
+                                                                                   m_safeatures(CrossProductFeatures(tilecoding, num_actions)),
+                                                                                   m_default_weight(default_weight), m_track_dirty(false),
+                                                                                   m_trace_precision(WeightVector::DOUBLE) {}
 
 double LinearFA::evaluate(State &s, Action &a)
 {
-    std::vector<StateFeature> features = m_safeatures.features(&s, a);
-    double val = 0.;
-    for (StateFeature sf : features) {
-        double prod = sf.m_value * get_weight(sf.m_id);
-        val += prod;
-    }
-    m_curr_value = val;
-    m_curr_gradient.clear();
-    m_curr_features = features;
+    features(&s, &a, m_curr_features);
+    m_curr_value = evaluate(m_curr_features);
 
     m_last_state = &s;
     m_last_action = &a;
 
+    return m_curr_value;
+}
+
+double LinearFA::evaluate(const std::vector<StateFeature> &features) const
+{
+    double val = 0.;
+    for (const StateFeature &sf : features)
+        val += sf.m_value * weight(sf.m_id);
     return val;
 }
 
-std::map<int, double> LinearFA::gradient(State *s, Action *a)
+void LinearFA::evaluate_all(State &s, const std::vector<Action *> &actions, std::vector<double> &q)
 {
-    std::vector<StateFeature> features;
+    evaluate_all(s, actions, q, m_state_features);
+}
 
-    if (*m_last_state == *s && *m_last_action == *a) {
-        if (m_curr_gradient.size() > 0)
-            return m_curr_gradient;
-        features = m_curr_features;
+void LinearFA::all_features(State &s, const std::vector<Action *> &actions, std::vector<StateFeature> &features)
+{
+    // features[0..num_sf) keeps the state features, followed by one block per action
+    m_safeatures.state_features(&s, features);
+    if (m_safeatures.has_recycled())
+        reset_recycled();
+    int num_sf = features.size();
+    features.resize(num_sf * (actions.size() + 1));
+    for (int i = 0; i < actions.size(); i++) {
+        StateFeature *block = &features[num_sf * (i + 1)];
+        for (int j = 0; j < num_sf; j++)
+            block[j] = StateFeature(m_safeatures.action_feature(*actions[i], features[j].m_id), features[j].m_value);
     }
-    else features = m_safeatures.features(s, *a);
+}
 
-    std::map<int, double> gd;
-    for (StateFeature sf : features)
-        gd[sf.m_id] = sf.m_value;
+void LinearFA::block_values(const std::vector<StateFeature> &features, std::vector<double> &q) const
+{
+    int num_sf = features.size() / (q.size() + 1);
+    for (int i = 0; i < q.size(); i++) {
+        const StateFeature *block = features.data() + num_sf * (i + 1);
+        double val = 0.;
+        for (int j = 0; j < num_sf; j++)
+            val += block[j].m_value * weight(block[j].m_id);
+        q[i] = val;
+    }
+}
 
-    m_curr_gradient = gd;
+void LinearFA::evaluate_all(State &s, const std::vector<Action *> &actions, std::vector<double> &q, std::vector<StateFeature> &features)
+{
+    {
+        std::unique_lock<std::mutex> lock;
+        if (m_mutex)
+            lock = std::unique_lock<std::mutex>(*m_mutex);
+        all_features(s, actions, features);
+    }
+    q.resize(actions.size());
+    block_values(features, q);
+}
+
+void LinearFA::evaluate_batch(const std::vector<State *> &states, const std::vector<std::vector<Action *>> &actions,
+                              std::vector<std::vector<double>> &q, std::vector<std::vector<StateFeature>> &features)
+{
+    {
+        std::unique_lock<std::mutex> lock;
+        if (m_mutex)
+            lock = std::unique_lock<std::mutex>(*m_mutex);
+        for (int i = 0; i < states.size(); i++) {
+            if (states[i] != nullptr)
+                all_features(*states[i], actions[i], features[i]);
+        }
+    }
+    for (int i = 0; i < states.size(); i++) {
+        if (states[i] != nullptr) {
+            q[i].resize(actions[i].size());
+            block_values(features[i], q[i]);
+        }
+    }
+}
+
+void LinearFA::lookup_all(const std::vector<double> &input, const std::vector<Action *> &actions, std::vector<double> &q,
+                          Tile &tile, std::vector<StateFeature> &features) const
+{
+    m_safeatures.find_state_features(input, tile, features);
+    q.resize(actions.size());
+    for (int i = 0; i < actions.size(); i++) {
+        double val = 0.;
+        for (const StateFeature &sf : features) {
+            int id = m_safeatures.find_action_feature(*actions[i], sf.m_id);
+            val += sf.m_value * (id < 0 ? m_default_weight : weight(id));
+        }
+        q[i] = val;
+    }
+}
+
+void LinearFA::features(State *s, Action *a, std::vector<StateFeature> &features)
+{
+    std::unique_lock<std::mutex> lock;
+    if (m_mutex)
+        lock = std::unique_lock<std::mutex>(*m_mutex);
+    m_safeatures.features(s, *a, features);
+    if (m_safeatures.has_recycled())
+        reset_recycled();
+}
+
+void LinearFA::reset_recycled()
+{
+    m_safeatures.take_recycled(m_recycled);
+    for (int id : m_recycled) {
+        if (id < (int)m_weights.size())
+            m_weights.set(id, m_default_weight);
+        // in concurrent mode m_generation is sized by set_concurrent() and must not move
+        if (id >= (int)m_generation.size() && !m_mutex)
+            m_generation.resize(id + 1, 0);
+        if (id < (int)m_generation.size())
+            m_generation[id]++;
+    }
+}
+
+bool LinearFA::set_feature_budget(int max_state_features)
+{
+    if (!m_safeatures.set_budget(max_state_features))
+        return false;
+    if (m_mutex && max_state_features > 0 && m_generation.size() < m_weights.size())
+        m_generation.resize(m_weights.size(), 0);
+    return true;
+}
+
+void LinearFA::set_concurrent(bool concurrent, int max_params)
+{
+    if (!concurrent) {
+        m_mutex.reset();
+        return;
+    }
+    if (max_params > (int)m_weights.size())
+        m_weights.resize(max_params, m_default_weight);
+    if (feature_budget() > 0 && m_generation.size() < m_weights.size())
+        m_generation.resize(m_weights.size(), 0);
+    if (!m_dropped)
+        m_dropped = std::make_shared<std::atomic<long>>(0);
+    if (!m_mutex)
+        m_mutex = std::make_shared<std::mutex>();
+}
+
+FeatureSpan LinearFA::gradient(State *s, Action *a)
+{
+    if (m_last_state != nullptr && (m_last_state == s || *m_last_state == *s) && m_last_action->m_num == a->m_num)
+        return FeatureSpan(m_curr_features);
+
+    features(s, a, m_curr_features);
     m_last_state = s;
     m_last_action = a;
-    m_curr_features = features;
 
-    return gd;
+    return FeatureSpan(m_curr_features);
 }
 
 int LinearFA::num_param()
@@ -117,13 +316,41 @@ int LinearFA::num_param()
 
 double LinearFA::get_weight(int weight_id)
 {
-    if (m_weights.find(weight_id) == m_weights.end()) {
-        m_weights[weight_id] = m_default_weight;
-        return m_default_weight;
+    if (weight_id >= (int)m_weights.size()) {
+        if (m_mutex)
+            return m_default_weight;
+        m_weights.resize(weight_id + 1, m_default_weight);
     }
     return m_weights[weight_id];
 }
 
+void LinearFA::set_precision(WeightVector::Precision weights, WeightVector::Precision traces)
+{
+    m_weights.set_precision(weights);
+    m_trace_precision = traces;
+}
+
+void LinearFA::update_weight(int weight_id, double delta)
+{
+    if (weight_id >= (int)m_weights.size()) {
+        if (m_mutex) {
+            m_dropped->fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_weights.resize(weight_id + 1, m_default_weight);
+    }
+    m_weights.add(weight_id, delta);
+
+    if (m_track_dirty) {
+        if (weight_id >= (int)m_dirty.size())
+            m_dirty.resize(m_weights.size(), 0);
+        if (!m_dirty[weight_id]) {
+            m_dirty[weight_id] = 1;
+            m_dirty_ids.push_back(weight_id);
+        }
+    }
+}
+
 void LinearFA::reset_params()
 {
     m_weights.clear();
@@ -21,18 +21,25 @@
 #include "tilecoding.hpp"
 #include "state.hpp"
 #include "action.hpp"
+#include "weightvector.hpp"
 
 #include <vector>
 #include <map>
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <atomic>
 
 namespace ia {
 	namespace rl {
 		/// Classe realiza o mapeamento do id de um parâmentro livre em outro id.
 		/// @see get_or_create()
 		class FeaturesMap {
+			friend class Snapshot;
+			friend class Checkpoint;
+
 		private:
 			std::map<int, int> m_features_map; ///< Mapeamento do id de parâmetro livre em outro id.
 
@@ -55,6 +62,11 @@ namespace ia {
 			/// @return Novo id resultado do mapeamento do parâmetro livre **from** em outro id.
 			int get_or_create(int from, int &feature_id);
 
+			/// Recupera um parâmetro livre sem criá-lo.
+			/// @param from Id do parâmetro livre que se deseja fazer o mapeamento.
+			/// @return Id mapeado ou -1, caso o mapeamento não exista.
+			int find(int from) const;
+
 			/// Carrega os parâmetros livres de um LinearFA.
 			/// @note Não utilize este operador em FeaturesMap, ao invés disto,
 			/// use em LinearFA.
@@ -63,7 +75,9 @@ namespace ia {
 				// FeaturesMap
 				char c = is.get(); // (
 				// ((iii,iii),(iii,iii))
-				do {
+				if (is.peek() == ')')
+					is.get(); // )
+				else do {
 					int key;
 					int value;
 					std::string line;
@@ -85,6 +99,8 @@ namespace ia {
 			/// use em LinearFA.
 			/// @see operator<<(std::ostream, LinearFA)
 			friend std::ostream& operator<<(std::ostream& os, const FeaturesMap& fm) {
+				if (fm.m_features_map.empty())
+					return os << "()";
 				auto it = fm.m_features_map.begin();
 				auto it2 = --fm.m_features_map.end();
 				os << "(";
@@ -99,6 +115,9 @@ namespace ia {
 		/// Todo id de parâmetro livre gerado por CrossProductFeature está associado a um par \f$ (s,a) \f$.
 		/// @see ia::rl::LinearFA ia::rl::GDSarsaLambda
 		class CrossProductFeatures {
+			friend class Snapshot;
+			friend class Checkpoint;
+
 		private:
 			TileCoding m_sfeatures; ///< Modelo de organização dos parâmetros livres TileCoding.
 			/// Mapeamento dos parâmetros livres de um estado **s** para o par \f$ (s,a) \f$.
@@ -106,12 +125,15 @@ namespace ia {
 			/// Mantém um id único para cada parâmetro livre do modelo.
 			/// @see FeatureMap::get_or_create()
 			int m_feature_id;
-
-			/// Realiza o mapeamento dos ids dos parâmetros livres de um estado **s** para o par \f$ (s,a) \f$.
-			/// @param a Ação **a** do par \f$ (s,a) \f$ que se deseja obter os parâmetros livres.
-			/// @param from Id do parâmetro livre do estado **s** que se deseja converter para o par \f$ (s,a) \f$.
-			/// @return Id de um parâmetro livre do estado **s** convertido para o par \f$ (s,a) \f$.
-			int action_feature(Action &a, int from);
+			/// Quantidade de ações do ambiente quando o mapeamento aritmético é utilizado
+			/// ou 0 para utilizar m_action_features.
+			/// @see action_feature()
+			int m_num_actions;
+			std::vector<int> m_recycled_states; ///< Parâmetros livres de estado reaproveitados, usado por take_recycled().
+			bool m_track_new; ///< Registra os pares \f$ (s,a) \f$ criados em m_new_pairs.
+			/// Número da ação, id do estado e id do par \f$ (s,a) \f$ criados desde o último checkpoint.
+			/// @see ia::rl::Checkpoint
+			std::vector<int> m_new_pairs;
 
 		public:
 			/// Cria um CrossProductFeatures com um modelo de organização TileCoding para os parâmetros livres.
@@ -119,6 +141,18 @@ namespace ia {
 			/// @see TileCoding
 			CrossProductFeatures(TileCoding sfeatures);
 
+			/// Cria um CrossProductFeatures que calcula o id do par \f$ (s,a) \f$ aritmeticamente.
+			///
+			/// O id do par \f$ (s,a) \f$ é \f$ s \times num\_actions + a \f$, em que **s** é o id do
+			/// parâmetro livre do estado e **a** é o número Action::m_num da ação. Nenhum mapeamento
+			/// é armazenado e os pesos de todas as ações de um mesmo parâmetro livre do estado ficam
+			/// contíguos em LinearFA::m_weights.
+			/// @param sfeatures Modelo TileCoding.
+			/// @param num_actions Quantidade de ações do ambiente. Todas as ações devem possuir
+			/// Action::m_num entre 0 e **num_actions** - 1.
+			/// @see TileCoding
+			CrossProductFeatures(TileCoding sfeatures, int num_actions);
+
             /// Cria um CrossProductFeatures a partir de outro CrossProductFeatures.
             ///
             /// Este construtor cria uma cópia completa de um outro CrossProductFeatures.
@@ -132,10 +166,69 @@ namespace ia {
 			/// @return Vetor com conjunto de parametros livres associados ao par \f$ (s,a) \f$
 			std::vector<StateFeature> features(State *s, Action &a);
 
+			/// Obtém todos os parâmetros livres relacionados ao par \f$ (s,a) \f$ reaproveitando um vetor.
+			/// @param s Estado **s** do par \f$ (s,a) \f$ que se deseja obter os parâmetros livres.
+			/// @param a Ação **a** do par \f$ (s,a) \f$ que se deseja obter os parâmetros livres.
+			/// @param features Vetor que recebe os parametros livres associados ao par \f$ (s,a) \f$.
+			void features(State *s, Action &a, std::vector<StateFeature> &features);
+
+			/// Obtém os parâmetros livres de um estado **s** sem associá-los a nenhuma ação.
+			/// @param s Estado **s** que se deseja obter os parâmetros livres.
+			/// @return Vetor com conjunto de parametros livres associados ao estado **s**.
+			/// @see action_feature()
+			std::vector<StateFeature> state_features(State *s);
+
+			/// Obtém os parâmetros livres de um estado **s** reaproveitando um vetor.
+			/// @param s Estado **s** que se deseja obter os parâmetros livres.
+			/// @param features Vetor que recebe os parametros livres associados ao estado **s**.
+			void state_features(State *s, std::vector<StateFeature> &features);
+
+			/// Converte o id de um parâmetro livre de um estado **s** para o par \f$ (s,a) \f$.
+			///
+			/// Quando **num_actions** é informado no construtor o id é calculado sem nenhuma consulta
+			/// a m_action_features. Utilize junto com state_features() para avaliar várias ações calculando os
+			/// parâmetros livres do estado uma única vez.
+			/// @param a Ação **a** do par \f$ (s,a) \f$.
+			/// @param from Id do parâmetro livre do estado **s**.
+			/// @return Id do parâmetro livre do par \f$ (s,a) \f$.
+			int action_feature(Action &a, int from);
+
+			/// Obtém os parâmetros livres já existentes de uma entrada sem criar novos.
+			/// @see TileCoding::find_features()
+			void find_state_features(const std::vector<double> &input, Tile &tile, std::vector<StateFeature> &features) const;
+
+			/// Converte o id de um parâmetro livre de um estado **s** para o par \f$ (s,a) \f$ sem criá-lo.
+			/// @param a Ação **a** do par \f$ (s,a) \f$.
+			/// @param from Id do parâmetro livre do estado **s**.
+			/// @return Id do parâmetro livre do par \f$ (s,a) \f$ ou -1, caso ele não exista.
+			int find_action_feature(const Action &a, int from) const;
+
 			/// Calcula a quantidade de parametros livres utilizados até o momento.
 			/// @return Quantidade de parâmetros livres utilizados.
 			int num_features();
 
+			/// Limita a quantidade de parâmetros livres de estado do TileCoding.
+			/// @param max_state_features Quantidade máxima ou 0 para não limitar.
+			/// @return **False** se o limite é menor que a quantidade de tilings ou **true**, caso contrário.
+			/// @see TileCoding::set_budget()
+			bool set_budget(int max_state_features) {
+				return m_sfeatures.set_budget(max_state_features);
+			}
+
+			/// TileCoding utilizado para os parâmetros livres de estado.
+			const TileCoding &tilecoding() const {
+				return m_sfeatures;
+			}
+
+			/// Indica se algum parâmetro livre de estado foi reaproveitado desde a última chamada de take_recycled().
+			bool has_recycled() const {
+				return m_sfeatures.has_recycled();
+			}
+
+			/// Obtém os pares \f$ (s,a) \f$ dos parâmetros livres de estado reaproveitados desde a última chamada.
+			/// @param ids Recebe os ids dos pares \f$ (s,a) \f$ existentes dos estados reaproveitados.
+			void take_recycled(std::vector<int> &ids);
+
 			/// Carrega os parâmetros livres de um LinearFA.
 			/// @note Não utilize este operador em CrossProductFeatures, ao invés disto,
 			/// use em LinearFA.
@@ -151,7 +244,9 @@ namespace ia {
 
 				// (...,((iii,...),(iii,...)))
 				char c = is.get(); // (
-				do {
+				if (is.peek() == ')')
+					c = is.get(); // )
+				else do {
 					int key;
 					FeaturesMap fm;
 					std::string line;
@@ -165,7 +260,14 @@ namespace ia {
 
 					cpf.m_action_features[key] = fm;
 				} while(c != ')');
-				is.get(); // )
+
+				// (...,(...),iii)
+				if (is.peek() == ',') {
+					is.get(); // ,
+					getline(is, line, ')'); // )
+					cpf.m_num_actions = stoi(line);
+				}
+				else is.get(); // )
 				return is;
 			}
 
@@ -175,12 +277,18 @@ namespace ia {
 			/// @see operator<<(std::ostream, LinearFA)
 			friend std::ostream& operator<<(std::ostream& os, const CrossProductFeatures& cpf) {
 				os << "(" << cpf.m_feature_id  << "," << cpf.m_sfeatures;
-				auto it = cpf.m_action_features.begin();
-				auto it2 = --cpf.m_action_features.end();
 				os << ",(";
-				for(; it != it2; ++it) 
-					os << "(" << it->first << "," << it->second << "),";
-				return os << "(" << it->first << "," << it->second << ")))";
+				if (!cpf.m_action_features.empty()) {
+					auto it = cpf.m_action_features.begin();
+					auto it2 = --cpf.m_action_features.end();
+					for(; it != it2; ++it)
+						os << "(" << it->first << "," << it->second << "),";
+					os << "(" << it->first << "," << it->second << ")";
+				}
+				os << ")";
+				if (cpf.m_num_actions > 0)
+					os << "," << cpf.m_num_actions;
+				return os << ")";
 			}
 		};
 
@@ -189,18 +297,58 @@ namespace ia {
 		/// Utilize-a também para calcular os valores **Q** do par \f$ (s,a) \f$.
 		/// @see ia::rl::TileCoding
 		class LinearFA {
+			friend class Snapshot;
+			friend class Checkpoint;
+			friend class PolicyCompiler;
+			friend class TabularQ;
+
 		private:
 			std::vector<StateFeature> m_curr_features; ///< Últimos parâmetros livres consultados pela função evaluate().
+			std::vector<StateFeature> m_state_features; ///< Parâmetros livres do estado usados por evaluate_all().
 			double m_curr_value; ///< Último valor calculado pela função evaluate().
-			std::map<int, double> m_curr_gradient; ///< Últimos pesos consultados pela função evaluate().
 
 			State *m_last_state; ///< Último estado recebido.
 			Action *m_last_action; ///< Última ação recebida.
 
 			CrossProductFeatures m_safeatures; ///< Parâmetros livres de um par \f$ (s,a) \f$.
 			double m_default_weight; ///< Peso inicial de todos os parâmetros livres.
+
+			/// Protege a criação de parâmetros livres quando o LinearFA é usado por várias threads.
+			/// @see set_concurrent()
+			std::shared_ptr<std::mutex> m_mutex;
+			/// Atualizações descartadas no modo concorrente por ids maiores ou iguais a **max_params**.
+			/// @see dropped_updates()
+			std::shared_ptr<std::atomic<long>> m_dropped;
+
+			bool m_track_dirty; ///< Registra os pesos modificados em m_dirty_ids.
+			std::vector<char> m_dirty; ///< Indica se cada peso está em m_dirty_ids.
+			/// Ids dos pesos modificados desde o último checkpoint.
+			/// @see ia::rl::Checkpoint
+			std::vector<int> m_dirty_ids;
+
+			WeightVector::Precision m_trace_precision; ///< Precisão dos traços de elegibilidade.
+
+			std::vector<int> m_recycled; ///< Pares \f$ (s,a) \f$ reaproveitados, usado por reset_recycled().
+			std::vector<unsigned int> m_generation; ///< Quantidade de vezes que cada par \f$ (s,a) \f$ foi reaproveitado.
+
+			/// Restaura o peso inicial dos pares \f$ (s,a) \f$ cujos tiles foram substituídos.
+			/// @see set_feature_budget()
+			void reset_recycled();
+
+			/// Preenche **features** com os parâmetros livres do estado seguidos de um bloco por ação.
+			/// Deve ser chamada com m_mutex travado no modo concorrente.
+			void all_features(State &s, const std::vector<Action *> &actions, std::vector<StateFeature> &features);
+
+			/// Calcula os valores **Q** a partir dos blocos preenchidos por all_features().
+			/// @param q Deve ter o tamanho da quantidade de ações.
+			void block_values(const std::vector<StateFeature> &features, std::vector<double> &q) const;
 		public:
-			std::map<int, double> m_weights; ///< Mapeamento de um parâmetro livre ao seu respectivo peso.
+			/// Peso de cada parâmetro livre indexado diretamente pelo seu id.
+			///
+			/// Os ids gerados por CrossProductFeatures são sequenciais, por isso os pesos
+			/// ficam em um vetor contíguo que cresce sob demanda.
+			/// @see get_weight() weight() update_weight() set_precision()
+			WeightVector m_weights;
 
 			/// Cria um aproximador de funções linear sem nenhuma configuração do gerador de parâmetros livres TileCoding.
 			/// @note Este construtor só deve ser chamado para criar um aproximador de funções para
@@ -217,29 +365,213 @@ namespace ia {
 			/// @param default_weight Peso inicial para todos os parâmetros livres.
 			LinearFA(TileCoding tilecoding, double default_weight);
 
+			/// Cria um aproximador de funções linear que calcula os ids dos pares \f$ (s,a) \f$ aritmeticamente.
+			/// @param tilecoding Gerador de parâmetros livres para um par \f$ (s,a) \f$.
+			/// @param default_weight Peso inicial para todos os parâmetros livres.
+			/// @param num_actions Quantidade de ações do ambiente.
+			/// @see CrossProductFeatures::CrossProductFeatures(TileCoding, int)
+			LinearFA(TileCoding tilecoding, double default_weight, int num_actions);
+
 			virtual ~LinearFA() { }
 
+			/// Cria uma cópia do aproximador, preservando a classe derivada.
+			/// @return Nova cópia, que deve ser destruída por quem a chamou.
+			/// @see ia::rl::PolicyServer::publish()
+			virtual LinearFA *clone() const {
+				return new LinearFA(*this);
+			}
+
 			/// Calcula o valor **Q** do par \f$(s,a) \f$.
 			/// @param s Estado **s** do par \f$(s,a) \f$ que se deseja obter o valor **Q**.
 			/// @param a Ação **a** do par \f$(s,a) \f$ que se deseja obter o valor **Q**.
 			/// @return Valor \f$ Q(s,a) \f$.
 			double evaluate(State &s, Action &a);
 
-			/// Obtém todos os parâmetros livres e seus respectivos pesos associados ao par \f$ (s,a) \f$
-			/// @param s Estado **s** do par \f$ (s,a) \f$ que se deseja obter os parâmetros livres e seus respectivos pesos.
-			/// @param a Ação **a** do par \f$ (s,a) \f$ que se deseja obter os parâmetros livres e seus respectivos pesos.
-			/// @return Mapeamento do id do parâmetro livre com seu respectivo peso.
-			std::map<int, double> gradient(State *s, Action *a);
+			/// Calcula o valor **Q** de um estado **s** para várias ações de uma só vez.
+			///
+			/// Os parâmetros livres do estado são calculados uma única vez e reutilizados
+			/// para todas as ações.
+			/// @param s Estado **s** que se deseja obter os valores **Q**.
+			/// @param actions Ações que se deseja avaliar no estado **s**.
+			/// @param q Vetor que recebe \f$ Q(s,a) \f$ na mesma ordem de **actions**.
+			void evaluate_all(State &s, const std::vector<Action *> &actions, std::vector<double> &q);
+
+			/// Calcula o valor **Q** de um estado **s** para várias ações usando um vetor de trabalho externo.
+			///
+			/// Pode ser chamada por várias threads ao mesmo tempo quando set_concurrent() está habilitado,
+			/// desde que cada thread utilize seus próprios vetores **q** e **features**.
+			/// @param s Estado **s** que se deseja obter os valores **Q**.
+			/// @param actions Ações que se deseja avaliar no estado **s**.
+			/// @param q Vetor que recebe \f$ Q(s,a) \f$ na mesma ordem de **actions**.
+			/// @param features Vetor de trabalho que recebe os parâmetros livres de todos os pares \f$ (s,a) \f$.
+			/// @see ia::rl::TabularQ
+			virtual void evaluate_all(State &s, const std::vector<Action *> &actions, std::vector<double> &q, std::vector<StateFeature> &features);
+
+			/// Calcula o valor **Q** das ações de vários estados em uma única avaliação.
+			///
+			/// Os parâmetros livres de todos os estados são obtidos com uma única aquisição do mutex
+			/// do modo concorrente. Os vetores de trabalho são reaproveitados entre as chamadas.
+			/// @param states Estados que se deseja avaliar. Posições com nullptr são ignoradas.
+			/// @param actions Ações que se deseja avaliar em cada estado.
+			/// @param q Recebe, para cada estado, \f$ Q(s,a) \f$ na mesma ordem de **actions**.
+			/// @param features Vetores de trabalho, um por estado.
+			/// @see ia::rl::VecEnv
+			virtual void evaluate_batch(const std::vector<State *> &states, const std::vector<std::vector<Action *>> &actions,
+							std::vector<std::vector<double>> &q, std::vector<std::vector<StateFeature>> &features);
+
+			/// Calcula o valor **Q** de uma entrada para várias ações sem modificar o LinearFA.
+			///
+			/// Nenhum parâmetro livre ou peso é criado: parâmetros livres desconhecidos são ignorados.
+			/// Como não altera o objeto, pode ser usada por várias threads sobre uma cópia imutável
+			/// do LinearFA e não aloca memória após os vetores de trabalho atingirem seu tamanho final.
+			/// @param input Variáveis do estado, como retornado por State::to_vec().
+			/// @param actions Ações que se deseja avaliar.
+			/// @param q Vetor que recebe \f$ Q(s,a) \f$ na mesma ordem de **actions**.
+			/// @param tile Tile de trabalho.
+			/// @param features Vetor de trabalho.
+			/// @see ia::rl::PolicyServer
+			virtual void lookup_all(const std::vector<double> &input, const std::vector<Action *> &actions, std::vector<double> &q,
+							Tile &tile, std::vector<StateFeature> &features) const;
+
+			/// Calcula o valor **Q** a partir de parâmetros livres já calculados.
+			/// @param features Parâmetros livres do par \f$ (s,a) \f$.
+			/// @return Valor \f$ Q(s,a) \f$.
+			double evaluate(const std::vector<StateFeature> &features) const;
+
+			/// Obtém os parâmetros livres do par \f$ (s,a) \f$ em um vetor externo.
+			///
+			/// Pode ser chamada por várias threads ao mesmo tempo quando set_concurrent() está habilitado.
+			/// @param s Estado **s** do par \f$ (s,a) \f$.
+			/// @param a Ação **a** do par \f$ (s,a) \f$.
+			/// @param features Vetor que recebe os parâmetros livres do par \f$ (s,a) \f$.
+			/// @see ia::rl::TabularQ
+			virtual void features(State *s, Action *a, std::vector<StateFeature> &features);
+
+			/// Habilita ou desabilita o uso do LinearFA por várias threads.
+			///
+			/// Com o modo concorrente habilitado, a criação de parâmetros livres em TileCoding e
+			/// CrossProductFeatures é protegida por um mutex e o vetor de pesos deixa de crescer:
+			/// ele é expandido uma única vez para **max_params** posições e pesos de parâmetros
+			/// livres com id maior são lidos como o peso inicial e nunca atualizados. As atualizações
+			/// dos pesos não são sincronizadas (estilo Hogwild).
+			///
+			/// As atualizações descartadas são contadas por dropped_updates(). Se a contagem crescer,
+			/// **max_params** é pequeno demais e parte do modelo deixou de aprender.
+			/// @param concurrent **True** para habilitar o modo concorrente.
+			/// @param max_params Quantidade de pesos reservados.
+			/// @see ia::rl::Hogwild
+			void set_concurrent(bool concurrent, int max_params = 0);
+
+			/// Verifica se o modo concorrente está habilitado.
+			/// @return **True** se o modo concorrente estiver habilitado.
+			bool is_concurrent() const {
+				return m_mutex != nullptr;
+			}
+
+			/// Quantidade de atualizações de pesos descartadas no modo concorrente porque o id do
+			/// parâmetro livre não cabe nos **max_params** pesos reservados.
+			/// @return Quantidade de atualizações descartadas desde a primeira chamada de set_concurrent().
+			/// @see set_concurrent()
+			long dropped_updates() const {
+				return m_dropped ? m_dropped->load(std::memory_order_relaxed) : 0;
+			}
+
+			/// Obtém o gradiente de \f$ Q(s,a) \f$, isto é, os parâmetros livres do par \f$ (s,a) \f$ e suas influências.
+			///
+			/// Se o par \f$ (s,a) \f$ for o mesmo da última chamada a evaluate(), os parâmetros livres
+			/// já calculados são reutilizados.
+			/// @param s Estado **s** do par \f$ (s,a) \f$ que se deseja obter o gradiente.
+			/// @param a Ação **a** do par \f$ (s,a) \f$ que se deseja obter o gradiente.
+			/// @return Sequência de pares (id, valor) dos parâmetros livres.
+			/// @note A sequência aponta para um vetor interno do LinearFA e só é válida até a próxima
+			/// chamada a evaluate() ou gradient().
+			FeatureSpan gradient(State *s, Action *a);
 
 			/// Obtém a quantidade de parâmetros livres utilizados.
 			/// @return Quantidade de parâmetros livres utilizados.
 			int num_param();
 
+			/// Limita a memória utilizada pelos parâmetros livres e pesos.
+			///
+			/// Limita a quantidade de tiles do TileCoding e, consequentemente, a quantidade de pares
+			/// \f$ (s,a) \f$ e de pesos, que passa a ser no máximo **max_state_features** vezes a
+			/// quantidade de ações. Ao atingir o limite, o tile menos usado recentemente é substituído
+			/// pelo novo tile, que reaproveita seus parâmetros livres com o peso inicial.
+			/// Os traços de elegibilidade dos pares reaproveitados são descartados por
+			/// EligibilityTraces na próxima atualização, comparando generation().
+			/// @param max_state_features Quantidade máxima de tiles ou 0 para não limitar. Deve ser
+			/// maior ou igual à quantidade de tilings.
+			/// @return **False** se o limite é menor que a quantidade de tilings, caso em que ele não é
+			/// alterado, ou **true**, caso contrário.
+			/// @see TileCoding::set_budget()
+			bool set_feature_budget(int max_state_features);
+
+			/// Quantidade máxima de tiles ou 0, caso não haja limite.
+			/// @see set_feature_budget()
+			int feature_budget() const {
+				return m_safeatures.tilecoding().budget();
+			}
+
+			/// Quantidade de vezes que o par \f$ (s,a) \f$ foi reaproveitado por set_feature_budget().
+			/// @param id Id do par \f$ (s,a) \f$.
+			/// @return Geração do par, que muda sempre que ele passa a representar outro tile.
+			unsigned int generation(int id) const {
+				if (id < (int)m_generation.size())
+					return m_generation[id];
+				return 0;
+			}
+
+			/// Quantidade de tiles substituídos para respeitar o limite de set_feature_budget().
+			long evictions() const {
+				return m_safeatures.tilecoding().evictions();
+			}
+
+			/// Altera a precisão do armazenamento dos pesos e dos traços de elegibilidade.
+			///
+			/// Com FLOAT a memória dos pesos cai pela metade e com HALF ou BFLOAT16 cai para um quarto,
+			/// o que também melhora o uso de cache em evaluate(). As contas continuam em double e os
+			/// pesos existentes são convertidos. Os traços de EligibilityTraces adotam
+			/// **traces** na próxima chamada a EligibilityTraces::update() ou EligibilityTraces::apply().
+			/// @param weights Precisão dos pesos.
+			/// @param traces Precisão dos traços de elegibilidade.
+			/// @see ia::rl::WeightVector
+			/// @note BFLOAT16 tem o alcance do float, mas somente 8 bits de mantissa. HALF tem mais
+			/// mantissa, mas só representa valores de até 65504 em módulo.
+			void set_precision(WeightVector::Precision weights, WeightVector::Precision traces = WeightVector::DOUBLE);
+
+			/// Precisão do armazenamento dos pesos.
+			WeightVector::Precision weight_precision() const {
+				return m_weights.precision();
+			}
+
+			/// Precisão do armazenamento dos traços de elegibilidade.
+			WeightVector::Precision trace_precision() const {
+				return m_trace_precision;
+			}
+
 			/// Obtém o peso de um parâmetro livre.
+			///
+			/// Caso o parâmetro livre ainda não possua peso, o vetor de pesos é expandido
+			/// com o peso inicial.
 			/// @param weight_id Id do parâmetro livre.
 			/// @return Peso do parâmetro livre.
 			double get_weight(int weight_id);
 
+			/// Obtém o peso de um parâmetro livre sem modificar o vetor de pesos.
+			/// @param weight_id Id do parâmetro livre.
+			/// @return Peso do parâmetro livre ou o peso inicial, caso ele ainda não exista.
+			double weight(int weight_id) const {
+				if (weight_id < (int)m_weights.size())
+					return m_weights[weight_id];
+				return m_default_weight;
+			}
+
+			/// Soma um valor ao peso de um parâmetro livre.
+			/// @note No modo concorrente, parâmetros livres fora do vetor de pesos são ignorados.
+			/// @param weight_id Id do parâmetro livre.
+			/// @param delta Valor somado ao peso.
+			void update_weight(int weight_id, double delta);
+
 			/// Limpa o peso de todos os parâmetros livres.
 			void reset_params();
 
@@ -264,7 +596,9 @@ namespace ia {
 
 				// (...,((iii,ddd),(iii,ddd)))
 				char c = is.get(); // (
-				do {
+				if (is.peek() == ')')
+					is.get(); // )
+				else do {
 					int key;
 					double value;
 					std::string line;
@@ -276,7 +610,9 @@ namespace ia {
 					value = stod(line);
 					c = is.get(); // , or )
 
-					lfa.m_weights[key] = value;
+					if (key >= (int)lfa.m_weights.size())
+						lfa.m_weights.resize(key + 1, lfa.m_default_weight);
+					lfa.m_weights.set(key, value);
 				} while(c != ')');
 				is.get(); // )
 				return is;
@@ -298,12 +634,13 @@ namespace ia {
 			/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 			friend std::ostream& operator<<(std::ostream& os, const LinearFA& lfa) {
 				os << "(" << lfa.m_safeatures;
-				auto it = lfa.m_weights.begin();
-				auto it2 = --lfa.m_weights.end();
+				if (lfa.m_weights.empty())
+					return os << ",())";
 				os << ",(";
-				for(; it != it2; ++it)
-					os << "(" << it->first << "," << it->second << "),";
-				return os << "(" << it->first << "," << it->second << ")))";
+				int last = lfa.m_weights.size() - 1;
+				for(int i=0;i<last;i++)
+					os << "(" << i << "," << lfa.m_weights[i] << "),";
+				return os << "(" << last << "," << lfa.m_weights[last] << ")))";
 			}
 		};
 	}
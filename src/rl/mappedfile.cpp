@@ -0,0 +1,87 @@
+/*
+ mappedfile.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "mappedfile.hpp"
+
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define MAPPEDFILE_MMAP
+#endif
+
+using namespace ia::rl;
+
+MappedFile::MappedFile() : m_data(nullptr), m_length(0), m_mapped(false) {}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const char *path)
+{
+    close();
+
+#ifdef MAPPEDFILE_MMAP
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            m_data = (const char *)p;
+            m_length = st.st_size;
+            m_mapped = true;
+        }
+    }
+    ::close(fd);
+#else
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr)
+        return false;
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (length > 0) {
+        m_buffer.resize(length);
+        if (fread(m_buffer.data(), 1, length, f) == (size_t)length) {
+            m_data = m_buffer.data();
+            m_length = length;
+        }
+    }
+    fclose(f);
+#endif
+
+    return m_data != nullptr;
+}
+
+void MappedFile::close()
+{
+#ifdef MAPPEDFILE_MMAP
+    if (m_mapped)
+        munmap((void *)m_data, m_length);
+#endif
+    std::vector<char>().swap(m_buffer);
+    m_data = nullptr;
+    m_length = 0;
+    m_mapped = false;
+}
@@ -0,0 +1,69 @@
+/*
+ mappedfile.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <vector>
+#include <cstddef>
+
+namespace ia {
+	namespace rl {
+		/// Conteúdo de um arquivo somente para leitura.
+		///
+		/// O arquivo é mapeado em memória quando o sistema suporta mmap(). Caso contrário, é lido
+		/// por completo para um vetor.
+		/// @see ia::rl::TrajectoryReader ia::rl::Snapshot
+		class MappedFile {
+		protected:
+			const char *m_data; ///< Conteúdo do arquivo.
+			size_t m_length; ///< Tamanho do arquivo em bytes.
+			bool m_mapped; ///< Indica se m_data foi mapeado com mmap().
+			std::vector<char> m_buffer; ///< Conteúdo do arquivo quando não é mapeado.
+
+		public:
+			/// Cria um MappedFile sem nenhum arquivo aberto.
+			MappedFile();
+
+			/// Fecha o arquivo aberto.
+			virtual ~MappedFile();
+
+			MappedFile(const MappedFile &) = delete;
+			MappedFile &operator=(const MappedFile &) = delete;
+
+			/// Abre um arquivo.
+			/// @param path Caminho do arquivo.
+			/// @return **True** se o arquivo foi aberto e não está vazio ou **false**, caso contrário.
+			bool open(const char *path);
+
+			/// Fecha o arquivo aberto.
+			void close();
+
+			/// Conteúdo do arquivo ou nullptr, caso nenhum arquivo esteja aberto.
+			const char *data() const {
+				return m_data;
+			}
+
+			/// Tamanho do arquivo em bytes.
+			size_t size() const {
+				return m_length;
+			}
+		};
+	}
+}
+
+#endif
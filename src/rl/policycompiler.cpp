@@ -0,0 +1,163 @@
+/*
+ policycompiler.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "policycompiler.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace ia::rl;
+
+bool PolicyCompiler::compile(const LinearFA &lfa, const std::vector<Action *> &actions, std::vector<char> &out, int max_cells)
+{
+    const TileCoding &tc = lfa.m_safeatures.tilecoding();
+    int num_tilings = tc.m_tilings.size();
+    int dim = num_tilings > 0 ? tc.m_tilings[0].m_widths.size() : 0;
+    int na = actions.size();
+    if (dim == 0 || na == 0 || na > FrozenPolicy::MAX_ACTIONS)
+        return false;
+
+    // bounding box of the visited tiles of each tiling
+    std::vector<int32_t> cell_base(num_tilings);
+    std::vector<FrozenDim> dims(num_tilings * dim);
+    int64_t num_cells = 0;
+    for (int t = 0; t < num_tilings; t++) {
+        const Tiling &tiling = tc.m_tilings[t];
+        if ((int)tiling.m_widths.size() != dim)
+            return false;
+        cell_base[t] = num_cells;
+        int64_t cells = tc.m_state_features[t].empty() ? 0 : 1;
+        for (int i = 0; i < dim; i++) {
+            FrozenDim &d = dims[t * dim + i];
+            d.m_offset = 0.f;
+            d.m_inv_width = 0.f;
+            d.m_min = 0;
+            d.m_extent = 1;
+            if (!tiling.m_dim_mask[i] || tc.m_state_features[t].empty())
+                continue;
+            int lo = INT32_MAX, hi = INT32_MIN;
+            for (auto &entry : tc.m_state_features[t]) {
+                int c = entry.first.m_tiled_vector[i];
+                lo = c < lo ? c : lo;
+                hi = c > hi ? c : hi;
+            }
+            d.m_offset = tiling.m_offset[i];
+            d.m_inv_width = 1. / tiling.m_widths[i];
+            d.m_min = lo;
+            d.m_extent = hi - lo + 1;
+            cells *= d.m_extent;
+            if (cells > max_cells)
+                return false;
+        }
+        // row-major strides, last dimension contiguous
+        int32_t stride = 1;
+        for (int i = dim - 1; i >= 0; i--) {
+            dims[t * dim + i].m_stride = stride;
+            stride *= dims[t * dim + i].m_extent;
+        }
+        // an empty tiling never matches: an extent of 0 rejects every coordinate
+        if (cells == 0)
+            dims[t * dim].m_extent = 0;
+        num_cells += cells;
+        if (num_cells > max_cells)
+            return false;
+    }
+
+    // unvisited cells contribute nothing, as in LinearFA::lookup_all()
+    std::vector<float> weights(num_cells * na, 0.f);
+    for (int t = 0; t < num_tilings; t++) {
+        for (auto &entry : tc.m_state_features[t]) {
+            int64_t c = cell_base[t];
+            for (int i = 0; i < dim; i++) {
+                const FrozenDim &d = dims[t * dim + i];
+                if (tc.m_tilings[t].m_dim_mask[i])
+                    c += (int64_t)(entry.first.m_tiled_vector[i] - d.m_min) * d.m_stride;
+            }
+            for (int a = 0; a < na; a++) {
+                int id = lfa.m_safeatures.find_action_feature(*actions[a], entry.second);
+                weights[c * na + a] = id < 0 ? lfa.m_default_weight : lfa.weight(id);
+            }
+        }
+    }
+
+    FrozenPolicyHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.m_magic, "DTFP", 4);
+    h.m_version = FrozenPolicyHeader::VERSION;
+    h.m_dim = dim;
+    h.m_num_tilings = num_tilings;
+    h.m_num_actions = na;
+    h.m_num_cells = num_cells;
+
+    std::vector<int32_t> action_nums(na);
+    for (int a = 0; a < na; a++)
+        action_nums[a] = actions[a]->m_num;
+
+    out.clear();
+    out.insert(out.end(), (const char *)&h, (const char *)(&h + 1));
+    out.insert(out.end(), (const char *)action_nums.data(), (const char *)(action_nums.data() + na));
+    out.insert(out.end(), (const char *)cell_base.data(), (const char *)(cell_base.data() + cell_base.size()));
+    out.insert(out.end(), (const char *)dims.data(), (const char *)(dims.data() + dims.size()));
+    out.insert(out.end(), (const char *)weights.data(), (const char *)(weights.data() + weights.size()));
+    return true;
+}
+
+bool PolicyCompiler::save(const LinearFA &lfa, const std::vector<Action *> &actions, const char *path, int max_cells)
+{
+    std::vector<char> out;
+    if (!compile(lfa, actions, out, max_cells))
+        return false;
+
+    FILE *f = fopen(path, "wb");
+    if (f == nullptr)
+        return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool PolicyCompiler::save_header(const LinearFA &lfa, const std::vector<Action *> &actions, const char *path, const char *name, int max_cells)
+{
+    std::vector<char> out;
+    if (!compile(lfa, actions, out, max_cells))
+        return false;
+
+    // name must be a valid C identifier
+    std::string id, guard;
+    for (const char *c = name; *c; c++) {
+        id += isalnum((unsigned char)*c) ? *c : '_';
+        guard += isalnum((unsigned char)*c) ? toupper((unsigned char)*c) : '_';
+    }
+    guard += "_H";
+
+    FILE *f = fopen(path, "w");
+    if (f == nullptr)
+        return false;
+    fprintf(f, "/* Política congelada gerada por ia::rl::PolicyCompiler. Não edite. */\n");
+    fprintf(f, "/* Fica somente na flash em alvos que mapeiam a flash na memória (Cortex-M, ESP32); no AVR é copiada para a RAM. */\n\n");
+    fprintf(f, "#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n", guard.c_str(), guard.c_str());
+    fprintf(f, "static const uint32_t %s[] = {", id.c_str());
+    int words = out.size() / 4;
+    for (int i = 0; i < words; i++) {
+        uint32_t w;
+        memcpy(&w, out.data() + i * 4, 4);
+        fprintf(f, "%s%s0x%08lxUL", i > 0 ? "," : "", i % 8 == 0 ? "\n    " : " ", (unsigned long)w);
+    }
+    fprintf(f, "\n};\n\n#endif\n");
+    return fclose(f) == 0;
+}
@@ -0,0 +1,83 @@
+/*
+ policycompiler.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef POLICYCOMPILER_H
+#define POLICYCOMPILER_H
+
+#include "linearfa.hpp"
+#include "frozenpolicy.hpp"
+
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Compila um LinearFA treinado em uma política gulosa congelada.
+		///
+		/// Para cada tiling, os tiles visitados durante o treinamento são dispostos em uma tabela
+		/// densa que cobre a menor caixa contendo todos eles, com os pesos de todas as ações de um
+		/// tile lado a lado. Os mapas do TileCoding e do CrossProductFeatures, os pesos em double e
+		/// as ações deixam de ser necessários: FrozenPolicy avalia a tabela sem alocar memória.
+		///
+		/// Assim como LinearFA::lookup_all(), tiles não visitados não contribuem com o valor **Q** e
+		/// pares \f$ (s,a) \f$ não visitados de um tile visitado valem o peso inicial.
+		/// @see ia::rl::FrozenPolicy ia::rl::Snapshot
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// // No computador, após o treinamento
+		/// ia::rl::PolicyCompiler::save_header(*gdsl.m_vfa, env->actions(), "motor_policy.h", "motor_policy");
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class PolicyCompiler {
+		public:
+			/// Gera uma política congelada.
+			/// @param lfa Aproximador de funções linear treinado.
+			/// @param actions Ações da política, na ordem de desempate de FrozenPolicy::greedy_action().
+			/// @param out Recebe a política.
+			/// @param max_cells Quantidade máxima de células da tabela densa.
+			/// @return **False** se não há tilings (por exemplo, em um TabularQ), se os tilings têm quantidades diferentes de dimensões, se há mais de
+			/// FrozenPolicy::MAX_ACTIONS ações ou se a tabela ultrapassa **max_cells** células.
+			static bool compile(const LinearFA &lfa, const std::vector<Action *> &actions, std::vector<char> &out, int max_cells = 1 << 20);
+
+			/// Grava uma política congelada em um arquivo binário.
+			/// @param lfa Aproximador de funções linear treinado.
+			/// @param actions Ações da política.
+			/// @param path Caminho do arquivo.
+			/// @param max_cells Quantidade máxima de células da tabela densa.
+			/// @return **True** se a política foi gravada ou **false**, caso contrário.
+			/// @see compile()
+			static bool save(const LinearFA &lfa, const std::vector<Action *> &actions, const char *path, int max_cells = 1 << 20);
+
+			/// Grava uma política congelada como um cabeçalho C com um vetor de uint32_t.
+			///
+			/// O vetor é **static const**, que fica somente na flash em microcontroladores que mapeiam a
+			/// flash no espaço de endereços, como Cortex-M. No AVR ele ocupa também a RAM.
+			/// @see ia::rl::FrozenPolicy
+			/// @param lfa Aproximador de funções linear treinado.
+			/// @param actions Ações da política.
+			/// @param path Caminho do cabeçalho.
+			/// @param name Nome do vetor, também usado na guarda de inclusão. Caracteres que não são
+			/// letras nem dígitos são trocados por '_'.
+			/// @param max_cells Quantidade máxima de células da tabela densa.
+			/// @return **True** se o cabeçalho foi gravado ou **false**, caso contrário.
+			/// @see compile()
+			static bool save_header(const LinearFA &lfa, const std::vector<Action *> &actions, const char *path, const char *name,
+			                        int max_cells = 1 << 20);
+		};
+	}
+}
+
+#endif
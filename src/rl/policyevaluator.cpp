@@ -0,0 +1,118 @@
+/*
+ policyevaluator.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "policyevaluator.hpp"
+
+#include <thread>
+
+using namespace ia::rl;
+
+PolicyEvaluator::PolicyEvaluator(const LinearFA *vfa, double E) : m_vfa(vfa), m_E(E) {}
+
+void PolicyEvaluator::seed(uint64_t seed)
+{
+    m_rng.seed(seed);
+}
+
+Action *PolicyEvaluator::select_action(Env *env, State *s, Worker &worker) const
+{
+    env->applicable_actions(s, worker.m_mask, worker.m_actions);
+    if (m_E > 0. && worker.m_rng.uniform() < m_E)
+        return worker.m_actions[worker.m_rng.uniform_int(worker.m_actions.size())];
+
+    s->get_vars(worker.m_input);
+    m_vfa->lookup_all(worker.m_input, worker.m_actions, worker.m_q, worker.m_tile, worker.m_features);
+    int best = 0;
+    for (int i = 1; i < worker.m_q.size(); i++) {
+        if (worker.m_q[i] > worker.m_q[best])
+            best = i;
+    }
+    return worker.m_actions[best];
+}
+
+double PolicyEvaluator::run_policy(Env *env, int max_steps, PolicyStats *stats, Worker &worker) const
+{
+    PolicyStats result;
+    State *curr_s = env->curr_obs();
+    while (!env->is_terminal() && (result.m_steps < max_steps || max_steps == -1)) {
+        Action *action = select_action(env, curr_s, worker);
+        StepOutcome eo = env->step(action);
+        result.m_return += eo.m_r;
+        result.m_steps++;
+        result.m_terminated = eo.m_terminated;
+
+        env->release_state(curr_s);
+        curr_s = eo.m_op;
+    }
+    env->release_state(curr_s);
+
+    if (stats != nullptr)
+        *stats = result;
+    return result.m_return;
+}
+
+double PolicyEvaluator::evaluate(Env *env, int num_rollouts, int max_steps, int num_threads, std::vector<PolicyStats> &stats) const
+{
+    stats.assign(num_rollouts, PolicyStats());
+    if (num_threads < 1)
+        num_threads = 1;
+    if (num_threads > num_rollouts)
+        num_threads = num_rollouts;
+
+    // clones are created here because env is not safe to share between threads
+    std::vector<Env *> envs;
+    for (int t = 0; t < num_threads; t++) {
+        Env *clone = env->clone();
+        if (clone == nullptr) {
+            for (Env *e : envs)
+                delete e;
+            envs.clear();
+            break;
+        }
+        envs.push_back(clone);
+    }
+
+    if (envs.empty()) {
+        // no clone() available: run every episode on env itself
+        Worker worker(m_rng.stream(1));
+        for (int i = 0; i < num_rollouts; i++) {
+            env->reset_env();
+            run_policy(env, max_steps, &stats[i], worker);
+        }
+    } else {
+        int n = envs.size();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < n; t++) {
+            threads.push_back(std::thread([this, &envs, num_rollouts, max_steps, n, t, &stats] {
+                Worker worker(m_rng.stream(t + 1));
+                for (int i = t; i < num_rollouts; i += n) {
+                    envs[t]->reset_env();
+                    run_policy(envs[t], max_steps, &stats[i], worker);
+                }
+            }));
+        }
+        for (std::thread &t : threads)
+            t.join();
+        for (Env *e : envs)
+            delete e;
+    }
+
+    double sum = 0.;
+    for (PolicyStats &ps : stats)
+        sum += ps.m_return;
+    return num_rollouts > 0 ? sum / num_rollouts : 0.;
+}
@@ -0,0 +1,119 @@
+/*
+ policyevaluator.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef POLICYEVALUATOR_H
+#define POLICYEVALUATOR_H
+
+#include "linearfa.hpp"
+#include "env.hpp"
+
+#include <vector>
+#include "rng.hpp"
+
+namespace ia {
+	namespace rl {
+		/// Resultado da execução de uma política em um episódio.
+		class PolicyStats {
+		public:
+			double m_return; ///< Soma das recompensas recebidas.
+			int m_steps; ///< Número de passos executados.
+			bool m_terminated; ///< Indica se o episódio terminou em um estado terminal.
+
+			/// Cria um resultado vazio.
+			PolicyStats() : m_return(0.), m_steps(0), m_terminated(false) { }
+		};
+
+		/// Executa uma política aprendida sem modificar o LinearFA.
+		///
+		/// As ações são escolhidas com LinearFA::lookup_all(), que não cria parâmetros livres nem pesos,
+		/// e nenhum Episode é criado: somente o retorno e o número de passos são acumulados. Como o
+		/// LinearFA não é modificado, vários episódios podem ser executados em paralelo.
+		/// @see ia::rl::GDSarsaLambda::run_policy()
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::PolicyEvaluator evaluator(gdsl.m_vfa, 0.); // Política gulosa
+		/// std::vector<ia::rl::PolicyStats> stats;
+		/// evaluator.evaluate(env, 1000, 200, 8, stats); // 1000 episódios em 8 threads
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class PolicyEvaluator {
+		private:
+			const LinearFA *m_vfa; ///< Aproximador de funções linear avaliado.
+			double m_E; ///< Exploração.
+			Rng m_rng; ///< Base das sequências de números aleatórios das threads de evaluate().
+
+		public:
+			/// Vetores de trabalho e gerador de números aleatórios de uma thread.
+			class Worker {
+			public:
+				ActionMask m_mask; ///< Máscara das ações realizáveis no estado corrente.
+				std::vector<Action *> m_actions; ///< Ações realizáveis no estado corrente.
+				std::vector<double> m_input; ///< Variáveis do estado corrente, preenchidas por State::get_vars().
+				std::vector<double> m_q; ///< Valores **Q** das ações em m_actions.
+				std::vector<StateFeature> m_features; ///< Parâmetros livres do estado corrente.
+				Tile m_tile; ///< Tile de trabalho.
+				Rng m_rng; ///< Gerador de números aleatórios.
+
+				/// Cria os vetores de trabalho de uma thread.
+				/// @param rng Gerador de números aleatórios.
+				Worker(const Rng &rng) : m_rng(rng) { }
+			};
+
+			/// Cria um avaliador de políticas.
+			/// @param vfa Aproximador de funções linear avaliado.
+			/// @param E Exploração. Utilize 0 para a política gulosa.
+			PolicyEvaluator(const LinearFA *vfa, double E);
+
+			virtual ~PolicyEvaluator() { }
+
+			/// Reinicia a base das sequências de números aleatórios de evaluate().
+			/// @param seed Semente.
+			void seed(uint64_t seed);
+
+			/// Escolhe uma ação seguindo a política E-greedy sem modificar o LinearFA.
+			/// @param env Ambiente.
+			/// @param s Estado do ambiente.
+			/// @param worker Vetores de trabalho da thread.
+			/// @return Ação escolhida.
+			Action *select_action(Env *env, State *s, Worker &worker) const;
+
+			/// Executa a política em um episódio.
+			/// @param env Ambiente. Não é reiniciado por esta função.
+			/// @param max_steps Número máximo de passos permitidos no episódio ou -1 para não limitar.
+			/// @param stats Recebe o resultado do episódio. Pode ser nullptr.
+			/// @param worker Vetores de trabalho da thread.
+			/// @return Soma das recompensas recebidas.
+			double run_policy(Env *env, int max_steps, PolicyStats *stats, Worker &worker) const;
+
+			/// Executa a política em vários episódios distribuídos entre várias threads.
+			///
+			/// Cada thread executa seus episódios em uma cópia do ambiente criada com Env::clone(),
+			/// reiniciada com Env::reset_env() antes de cada episódio. As cópias são criadas na thread
+			/// que chamou esta função. Se o ambiente não implementar Env::clone(), todos os episódios
+			/// são executados em sequência no próprio **env**.
+			/// @param env Ambiente usado como modelo para as cópias.
+			/// @param num_rollouts Número de episódios.
+			/// @param max_steps Número máximo de passos de cada episódio ou -1 para não limitar.
+			/// @param num_threads Número de threads. Valores menores que 1 são tratados como 1.
+			/// @param stats Recebe o resultado de cada episódio, na ordem dos episódios.
+			/// @return Retorno médio dos episódios.
+			double evaluate(Env *env, int num_rollouts, int max_steps, int num_threads, std::vector<PolicyStats> &stats) const;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ policyserver.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "policyserver.hpp"
+
+#include <algorithm>
+
+using namespace ia::rl;
+
+PolicyServer::Reader::~Reader()
+{
+    if (m_server != nullptr)
+        m_server->detach(*this);
+}
+
+PolicyServer::PolicyServer() : m_current(nullptr), m_version(0) {}
+
+PolicyServer::~PolicyServer()
+{
+    for (Reader *reader : m_readers)
+        reader->m_server = nullptr;
+    for (const LinearFA *vfa : m_retired)
+        delete vfa;
+    delete m_current.load();
+}
+
+void PolicyServer::attach(Reader &reader) const
+{
+    if (reader.m_server != nullptr)
+        reader.m_server->detach(reader);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_readers.push_back(&reader);
+    reader.m_server = this;
+}
+
+void PolicyServer::detach(Reader &reader) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_readers.erase(std::remove(m_readers.begin(), m_readers.end(), &reader), m_readers.end());
+    reader.m_server = nullptr;
+}
+
+void PolicyServer::reclaim()
+{
+    // a consulta anuncia a versão em m_hazard e confirma que ela ainda é a atual antes de usá-la,
+    // logo, depois da troca de m_current, uma versão substituída que não é anunciada por nenhum
+    // Reader não pode mais ser lida
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int kept = 0;
+    for (const LinearFA *vfa : m_retired) {
+        bool in_use = false;
+        for (const Reader *reader : m_readers) {
+            if (reader->m_hazard.load() == vfa) {
+                in_use = true;
+                break;
+            }
+        }
+        if (in_use)
+            m_retired[kept++] = vfa;
+        else
+            delete vfa;
+    }
+    m_retired.resize(kept);
+}
+
+void PolicyServer::publish(const LinearFA &vfa)
+{
+    const LinearFA *old = m_current.exchange(vfa.clone());
+    m_version++;
+    if (old != nullptr)
+        m_retired.push_back(old);
+    reclaim();
+}
+
+Action *PolicyServer::greedy_action(const State *s, const std::vector<Action *> &actions, Reader &reader) const
+{
+    if (reader.m_server != this)
+        attach(reader);
+
+    // anuncia a versão lida e confirma que ela não foi substituída nesse intervalo
+    const LinearFA *vfa;
+    do {
+        vfa = m_current.load();
+        reader.m_hazard.store(vfa);
+    } while (vfa != m_current.load());
+
+    Action *best = actions[0];
+    if (vfa != nullptr) {
+        s->get_vars(reader.m_input);
+        vfa->lookup_all(reader.m_input, actions, reader.m_q, reader.m_tile, reader.m_features);
+        for (int i = 1; i < reader.m_q.size(); i++) {
+            if (reader.m_q[i] > reader.m_q[0]) {
+                reader.m_q[0] = reader.m_q[i];
+                best = actions[i];
+            }
+        }
+    }
+    reader.m_hazard.store(nullptr);
+    return best;
+}
@@ -0,0 +1,134 @@
+/*
+ policyserver.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef POLICYSERVER_H
+#define POLICYSERVER_H
+
+#include "linearfa.hpp"
+#include "action.hpp"
+#include "state.hpp"
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace ia {
+	namespace rl {
+		/// Consulta a política gulosa enquanto a aprendizagem continua em outra thread.
+		///
+		/// A thread de aprendizagem publica versões imutáveis do LinearFA com publish(). As threads de
+		/// controle consultam a última versão publicada com greedy_action() sem travas e sem modificar o
+		/// LinearFA. Cada consulta anuncia a versão que está lendo no seu Reader e versões antigas são
+		/// liberadas pela thread que publica assim que nenhum Reader as anuncia. Versões ainda em uso
+		/// são verificadas novamente na publicação seguinte.
+		/// @see ia::rl::LinearFA::lookup_all()
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::PolicyServer server;
+		///
+		/// // thread de aprendizagem
+		/// while (true) {
+		///		delete gdsl.run_learning(env, 100);
+		///		env->reset_env();
+		///		server.publish(*gdsl.m_vfa); // Publica uma nova versão dos pesos
+		/// }
+		///
+		/// // thread de controle
+		/// ia::rl::PolicyServer::Reader reader; // Vetores de trabalho desta thread
+		/// ia::rl::Action *a = server.greedy_action(s, actions, reader);
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class PolicyServer {
+		public:
+			/// Vetores de trabalho de uma thread de consulta.
+			///
+			/// Cada thread que chama greedy_action() deve possuir seu próprio Reader. O Reader é
+			/// registrado no PolicyServer na primeira consulta e removido na sua destruição.
+			class Reader {
+			public:
+				std::vector<double> m_input; ///< Variáveis do estado consultado.
+				std::vector<double> m_q; ///< Valores **Q** das ações consultadas.
+				std::vector<StateFeature> m_features; ///< Parâmetros livres do estado consultado.
+				Tile m_tile; ///< Tile de trabalho.
+
+				Reader() : m_hazard(nullptr), m_server(nullptr) { }
+
+				virtual ~Reader();
+
+			private:
+				std::atomic<const LinearFA *> m_hazard; ///< Versão lida pela consulta em andamento ou nullptr.
+				const PolicyServer *m_server; ///< PolicyServer em que o Reader está registrado.
+
+				friend class PolicyServer;
+			};
+
+		private:
+			std::atomic<const LinearFA *> m_current; ///< Última versão publicada.
+			std::atomic<int> m_version; ///< Número da última versão publicada.
+			std::vector<const LinearFA *> m_retired; ///< Versões substituídas aguardando liberação.
+
+			mutable std::mutex m_mutex; ///< Protege m_readers.
+			mutable std::vector<Reader *> m_readers; ///< Readers registrados.
+
+			/// Libera as versões substituídas que não são anunciadas por nenhum Reader.
+			void reclaim();
+
+			/// Registra um Reader. Chamada somente na primeira consulta de cada Reader.
+			void attach(Reader &reader) const;
+
+			/// Remove o registro de um Reader.
+			void detach(Reader &reader) const;
+
+		public:
+			/// Cria um PolicyServer sem nenhuma versão publicada.
+			PolicyServer();
+
+			/// Destrutor.
+			///
+			/// Libera todas as versões publicadas e remove o registro dos Readers. Nenhuma consulta
+			/// pode estar em andamento.
+			virtual ~PolicyServer();
+
+			/// Publica uma cópia do LinearFA como a versão atual.
+			///
+			/// O custo é proporcional ao tamanho do modelo, por isso deve ser chamada periodicamente,
+			/// por exemplo ao fim de cada episódio. Somente uma thread pode publicar.
+			/// @param vfa Aproximador de funções linear que será copiado com LinearFA::clone().
+			void publish(const LinearFA &vfa);
+
+			/// Encontra a melhor ação segundo a última versão publicada.
+			///
+			/// Pode ser chamada por várias threads ao mesmo tempo, cada uma com seu próprio **reader**.
+			/// Somente a primeira consulta de um **reader** utiliza uma trava. As variáveis do estado são
+			/// obtidas com State::get_vars() em Reader::m_input.
+			/// @param s Estado do ambiente.
+			/// @param actions Ações realizáveis no estado **s**.
+			/// @param reader Vetores de trabalho da thread que faz a consulta.
+			/// @return Melhor ação **a** de acordo com a última versão publicada ou a primeira ação de
+			/// **actions**, caso nenhuma versão tenha sido publicada.
+			Action *greedy_action(const State *s, const std::vector<Action *> &actions, Reader &reader) const;
+
+			/// Número da última versão publicada.
+			/// @return Número da última versão publicada ou 0, caso nenhuma versão tenha sido publicada.
+			int version() const {
+				return m_version.load();
+			}
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ prioritizedreplay.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "prioritizedreplay.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+using namespace ia::rl;
+
+SumTree::SumTree(int capacity) : m_leaves(1)
+{
+    while (m_leaves < capacity)
+        m_leaves *= 2;
+    m_tree.resize(2 * m_leaves, 0.);
+}
+
+void SumTree::set(int i, double priority)
+{
+    int j = m_leaves + i;
+    m_tree[j] = priority;
+    for (j /= 2; j >= 1; j /= 2)
+        m_tree[j] = m_tree[2 * j] + m_tree[2 * j + 1];
+}
+
+int SumTree::find(double value) const
+{
+    int j = 1;
+    while (j < m_leaves) {
+        if (value < m_tree[2 * j] || m_tree[2 * j + 1] <= 0.)
+            j = 2 * j;
+        else {
+            value -= m_tree[2 * j];
+            j = 2 * j + 1;
+        }
+    }
+    return j - m_leaves;
+}
+
+void SumTree::clear()
+{
+    std::fill(m_tree.begin(), m_tree.end(), 0.);
+}
+
+PrioritizedReplayBuffer::PrioritizedReplayBuffer(int capacity, int state_dim, double alpha, double beta, double epsilon) :
+    ReplayBuffer(capacity, state_dim), m_priorities(capacity), m_alpha(alpha), m_beta(beta), m_epsilon(epsilon),
+    m_max_priority(1.) {}
+
+int PrioritizedReplayBuffer::add(const State &s, const Action &a, double r, const State &next_s, bool terminal, const ActionMask *next_mask)
+{
+    int i = ReplayBuffer::add(s, a, r, next_s, terminal, next_mask);
+    m_priorities.set(i, m_max_priority);
+    return i;
+}
+
+void PrioritizedReplayBuffer::sample(int batch_size, std::vector<int> &indices, std::vector<double> &is_weights)
+{
+    double total = m_priorities.total();
+    double segment = total / batch_size;
+    double max_weight = 0.;
+
+    indices.resize(batch_size);
+    is_weights.resize(batch_size);
+    for (int k = 0; k < batch_size; k++) {
+        int i = m_priorities.find((k + m_rng.uniform()) * segment);
+        if (i >= m_size)
+            i = m_size - 1;
+        indices[k] = i;
+        is_weights[k] = pow(m_size * m_priorities.get(i) / total, -m_beta);
+        if (is_weights[k] > max_weight)
+            max_weight = is_weights[k];
+    }
+
+    for (double &w : is_weights)
+        w /= max_weight;
+}
+
+void PrioritizedReplayBuffer::update_priorities(const std::vector<int> &indices, const std::vector<double> &deltas)
+{
+    for (int k = 0; k < indices.size(); k++) {
+        double priority = pow(fabs(deltas[k]) + m_epsilon, m_alpha);
+        if (priority > m_max_priority)
+            m_max_priority = priority;
+        m_priorities.set(indices[k], priority);
+    }
+}
+
+void PrioritizedReplayBuffer::replay(LinearFA &vfa, const std::vector<Action *> &actions, int batch_size, double alpha, double gamma)
+{
+    if (m_size == 0)
+        return;
+    sample(batch_size, m_batch, m_is_weights);
+    m_deltas.resize(batch_size);
+    for (int k = 0; k < batch_size; k++)
+        m_deltas[k] = update(vfa, actions, m_batch[k], alpha * m_is_weights[k], gamma);
+    update_priorities(m_batch, m_deltas);
+}
+
+void PrioritizedReplayBuffer::clear()
+{
+    ReplayBuffer::clear();
+    m_priorities.clear();
+    m_max_priority = 1.;
+}
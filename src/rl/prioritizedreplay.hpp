@@ -0,0 +1,138 @@
+/*
+ prioritizedreplay.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef PRIORITIZEDREPLAY_H
+#define PRIORITIZEDREPLAY_H
+
+#include "replaybuffer.hpp"
+
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Árvore de somas armazenada em vetor.
+		///
+		/// Cada folha guarda a prioridade de uma transição e cada nó interno a soma de seus filhos,
+		/// permitindo atualizar uma prioridade e sortear uma folha proporcionalmente à sua
+		/// prioridade em O(log n).
+		class SumTree {
+		private:
+			int m_leaves; ///< Quantidade de folhas, sempre uma potência de 2.
+			std::vector<double> m_tree; ///< Nós da árvore. A raiz fica na posição 1 e as folhas a partir de m_leaves.
+
+		public:
+			/// Cria uma árvore com todas as prioridades iguais a 0.
+			/// @param capacity Quantidade mínima de folhas.
+			SumTree(int capacity);
+
+			virtual ~SumTree() { }
+
+			/// Altera a prioridade de uma folha.
+			/// @param i Índice da folha.
+			/// @param priority Nova prioridade.
+			void set(int i, double priority);
+
+			/// Obtém a prioridade de uma folha.
+			/// @param i Índice da folha.
+			/// @return Prioridade da folha.
+			double get(int i) const {
+				return m_tree[m_leaves + i];
+			}
+
+			/// Encontra a folha cuja soma acumulada das prioridades contém **value**.
+			/// @param value Valor entre 0 e total().
+			/// @return Índice da folha.
+			int find(double value) const;
+
+			/// Altera a prioridade de todas as folhas para 0.
+			void clear();
+
+			/// Soma de todas as prioridades.
+			/// @return Soma de todas as prioridades.
+			double total() const {
+				return m_tree[1];
+			}
+		};
+
+		/// Buffer de transições com amostragem priorizada pelo erro TD.
+		///
+		/// Cada transição é sorteada com probabilidade proporcional a \f$ (|\delta| + \epsilon)^{\alpha} \f$ e
+		/// sua atualização é corrigida pelo peso de amostragem por importância
+		/// \f$ (N \cdot P(i))^{-\beta} \f$, normalizado pelo maior peso da amostra. Novas transições
+		/// recebem a maior prioridade vista até o momento para que sejam sorteadas ao menos uma vez.
+		/// Os vetores da amostra são reaproveitados entre as chamadas de replay().
+		/// @see ia::rl::ReplayBuffer ia::rl::SumTree
+		class PrioritizedReplayBuffer : public ReplayBuffer {
+		private:
+			SumTree m_priorities; ///< Prioridade de cada transição.
+			double m_alpha; ///< Expoente das prioridades.
+			double m_beta; ///< Expoente da correção por amostragem por importância.
+			double m_epsilon; ///< Valor somado a \f$ |\delta| \f$ para que nenhuma prioridade seja 0.
+			double m_max_priority; ///< Maior prioridade atribuída até o momento.
+
+			std::vector<double> m_is_weights; ///< Pesos de amostragem por importância da última amostra.
+			std::vector<double> m_deltas; ///< Erros TD da última amostra.
+
+		public:
+			/// Cria um buffer priorizado vazio.
+			/// @param capacity Quantidade máxima de transições.
+			/// @param state_dim Quantidade de variáveis de um estado.
+			/// @param alpha Expoente das prioridades. 0 equivale à amostragem uniforme.
+			/// @param beta Expoente da correção por amostragem por importância. 1 corrige totalmente o viés.
+			/// @param epsilon Valor somado a \f$ |\delta| \f$ para que nenhuma prioridade seja 0.
+			PrioritizedReplayBuffer(int capacity, int state_dim, double alpha, double beta, double epsilon);
+
+			virtual ~PrioritizedReplayBuffer() { }
+
+			/// Adiciona uma transição com a maior prioridade vista até o momento em O(log n).
+			/// @see ReplayBuffer::add()
+			int add(const State &s, const Action &a, double r, const State &next_s, bool terminal,
+			        const ActionMask *next_mask = nullptr) override;
+
+			/// Sorteia transições proporcionalmente às suas prioridades em O(log n) cada.
+			///
+			/// A amostragem é estratificada: a soma das prioridades é dividida em **batch_size**
+			/// intervalos iguais e uma transição é sorteada em cada intervalo.
+			/// @param batch_size Quantidade de transições sorteadas.
+			/// @param indices Vetor que recebe os índices das transições sorteadas.
+			/// @param is_weights Vetor que recebe os pesos de amostragem por importância normalizados.
+			void sample(int batch_size, std::vector<int> &indices, std::vector<double> &is_weights);
+
+			/// Atualiza a prioridade de várias transições a partir de seus erros TD.
+			/// @param indices Índices das transições.
+			/// @param deltas Erros TD \f$ \delta \f$ na mesma ordem de **indices**.
+			void update_priorities(const std::vector<int> &indices, const std::vector<double> &deltas);
+
+			/// Sorteia transições por prioridade, atualiza o LinearFA e as prioridades das transições.
+			/// @see ReplayBuffer::replay()
+			void replay(LinearFA &vfa, const std::vector<Action *> &actions, int batch_size, double alpha, double gamma) override;
+
+			/// Altera o expoente da correção por amostragem por importância.
+			///
+			/// Normalmente **beta** cresce até 1 ao longo do treinamento.
+			/// @param beta Novo expoente.
+			void set_beta(double beta) {
+				m_beta = beta;
+			}
+
+			/// Descarta todas as transições e suas prioridades.
+			void clear() override;
+		};
+	}
+}
+
+#endif
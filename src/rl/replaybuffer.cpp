@@ -0,0 +1,146 @@
+/*
+ replaybuffer.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "replaybuffer.hpp"
+
+using namespace ia::rl;
+
+ReplayBuffer::ReplayBuffer(int capacity, int state_dim) :
+    m_capacity(capacity), m_dim(state_dim), m_size(0), m_next(0),
+    m_states(capacity * state_dim), m_next_states(capacity * state_dim), m_actions(capacity),
+    m_rewards(capacity), m_terminals(capacity), m_mask_words(0), m_masked(capacity) {}
+
+void ReplayBuffer::store(const State &s, std::vector<double> &dest, int i)
+{
+    s.get_vars(m_vars);
+    int n = m_vars.size() < m_dim ? m_vars.size() : m_dim;
+    std::copy(m_vars.begin(), m_vars.begin() + n, dest.begin() + i * m_dim);
+    std::fill(dest.begin() + i * m_dim + n, dest.begin() + (i + 1) * m_dim, 0.);
+}
+
+void ReplayBuffer::write(int i, const State &s, const Action &a, double r, const State &next_s, bool terminal, const ActionMask *next_mask)
+{
+    store(s, m_states, i);
+    store(next_s, m_next_states, i);
+    m_actions[i] = a.m_num;
+    m_rewards[i] = r;
+    m_terminals[i] = terminal;
+
+    // the number of actions is fixed, so the mask size is taken from the first mask
+    if (next_mask != nullptr && m_mask_words == 0) {
+        m_mask_words = (next_mask->size() + 63) / 64;
+        m_next_masks.resize(m_capacity * m_mask_words);
+    }
+    m_masked[i] = next_mask != nullptr && next_mask->size() <= m_mask_words * 64;
+    if (m_masked[i]) {
+        uint64_t *row = &m_next_masks[i * m_mask_words];
+        std::fill(row, row + m_mask_words, 0);
+        for (int j = next_mask->next(0); j >= 0; j = next_mask->next(j + 1))
+            row[j >> 6] |= (uint64_t)1 << (j & 63);
+    }
+}
+
+int ReplayBuffer::add(const State &s, const Action &a, double r, const State &next_s, bool terminal, const ActionMask *next_mask)
+{
+    int i = m_next;
+    write(i, s, a, r, next_s, terminal, next_mask);
+
+    m_next = (m_next + 1) % m_capacity;
+    if (m_size < m_capacity)
+        m_size++;
+    return i;
+}
+
+int ReplayBuffer::add(const EnvOutcome &eo)
+{
+    return add(*eo.m_o, *eo.m_a, eo.m_r, *eo.m_op, eo.m_terminated);
+}
+
+void ReplayBuffer::sample(int batch_size, std::vector<int> &indices)
+{
+    indices.resize(batch_size);
+    for (int i = 0; i < batch_size; i++)
+        indices[i] = m_rng.uniform_int(m_size);
+}
+
+void ReplayBuffer::seed(uint64_t seed)
+{
+    m_rng.seed(seed);
+}
+
+Action *ReplayBuffer::find_action(const std::vector<Action *> &actions, int num)
+{
+    for (Action *a : actions) {
+        if (a->m_num == num)
+            return a;
+    }
+    return nullptr;
+}
+
+double ReplayBuffer::update(LinearFA &vfa, const std::vector<Action *> &actions, int i, double alpha, double gamma)
+{
+    Action *a = find_action(actions, m_actions[i]);
+    if (a == nullptr)
+        return 0.;
+
+    RowState s(state(i), m_dim);
+    double next_Q = 0.;
+    if (!m_terminals[i]) {
+        // only the actions applicable in s' take part in the max, when they are known
+        const std::vector<Action *> *next_actions = &actions;
+        if (m_masked[i]) {
+            const uint64_t *row = &m_next_masks[i * m_mask_words];
+            m_next_actions.clear();
+            for (int j = 0; j < actions.size() && j < m_mask_words * 64; j++) {
+                if ((row[j >> 6] >> (j & 63)) & 1)
+                    m_next_actions.push_back(actions[j]);
+            }
+            next_actions = &m_next_actions;
+        }
+        if (!next_actions->empty()) {
+            RowState next_s(next_state(i), m_dim);
+            vfa.evaluate_all(next_s, *next_actions, m_q, m_features);
+            next_Q = m_q[0];
+            for (double q : m_q) {
+                if (q > next_Q)
+                    next_Q = q;
+            }
+        }
+    }
+
+    vfa.features(&s, a, m_features);
+    double curr_Q = vfa.evaluate(m_features);
+    double delta = m_rewards[i] + gamma * next_Q - curr_Q;
+    for (const StateFeature &sf : m_features)
+        vfa.update_weight(sf.m_id, alpha * delta * sf.m_value);
+    return delta;
+}
+
+void ReplayBuffer::replay(LinearFA &vfa, const std::vector<Action *> &actions, int batch_size, double alpha, double gamma)
+{
+    if (m_size == 0)
+        return;
+    sample(batch_size, m_batch);
+    for (int i : m_batch)
+        update(vfa, actions, i, alpha, gamma);
+}
+
+void ReplayBuffer::clear()
+{
+    m_size = 0;
+    m_next = 0;
+}
@@ -0,0 +1,186 @@
+/*
+ replaybuffer.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef REPLAYBUFFER_H
+#define REPLAYBUFFER_H
+
+#include "linearfa.hpp"
+#include "envoutcome.hpp"
+#include "action.hpp"
+#include "state.hpp"
+#include "actionmask.hpp"
+
+#include <vector>
+#include "rng.hpp"
+
+namespace ia {
+	namespace rl {
+		/// Buffer circular de transições \f$ (s,a,r,s') \f$ para reaproveitar a experiência.
+		///
+		/// As transições são armazenadas em vetores contíguos, um para cada campo: variáveis dos
+		/// estados, número da ação, recompensa, fim de episódio e, opcionalmente, as ações realizáveis
+		/// em **s'**. Quando o buffer está cheio, a transição mais antiga é substituída.
+		/// @see ia::rl::GDSarsaLambda::m_replay
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::ReplayBuffer replay(10000, 2); // 10000 transições de estados com 2 variáveis
+		/// gdsl.m_replay = &replay; // O agente grava as transições no buffer
+		/// delete gdsl.run_learning(env, 100);
+		/// replay.replay(*gdsl.m_vfa, env->actions(), 32, 0.05, 0.95); // Reaproveita 32 transições
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class ReplayBuffer {
+		protected:
+			/// Estado que lê suas variáveis de uma linha do buffer.
+			class RowState : public State {
+			public:
+				const double *m_row; ///< Variáveis do estado.
+				int m_dim; ///< Quantidade de variáveis.
+
+				RowState(const double *row, int dim) : m_row(row), m_dim(dim) { }
+
+				std::vector<double> to_vec() const override {
+					return std::vector<double>(m_row, m_row + m_dim);
+				}
+
+				void get_vars(std::vector<double> &vars) const override {
+					vars.assign(m_row, m_row + m_dim);
+				}
+			};
+
+			int m_capacity; ///< Quantidade máxima de transições.
+			int m_dim; ///< Quantidade de variáveis de um estado.
+			int m_size; ///< Quantidade de transições armazenadas.
+			int m_next; ///< Posição onde a próxima transição será gravada.
+
+			std::vector<double> m_states; ///< Variáveis do estado **s** de cada transição.
+			std::vector<double> m_next_states; ///< Variáveis do estado **s'** de cada transição.
+			std::vector<int> m_actions; ///< Número da ação de cada transição.
+			std::vector<double> m_rewards; ///< Recompensa de cada transição.
+			std::vector<char> m_terminals; ///< Indica se **s'** é um estado terminal.
+			int m_mask_words; ///< Palavras de 64 bits de cada máscara ou 0 enquanto nenhuma máscara foi gravada.
+			std::vector<uint64_t> m_next_masks; ///< Ações realizáveis em **s'** de cada transição.
+			std::vector<char> m_masked; ///< Indica se a transição possui as ações realizáveis em **s'**.
+
+			Rng m_rng; ///< Gerador de números aleatórios.
+
+			std::vector<int> m_batch; ///< Índices da última amostra.
+			std::vector<double> m_q; ///< Valores **Q** de **s'**.
+			std::vector<StateFeature> m_features; ///< Parâmetros livres do par \f$ (s,a) \f$ atualizado.
+			std::vector<Action *> m_next_actions; ///< Ações realizáveis em **s'** consideradas no máximo.
+			std::vector<double> m_vars; ///< Variáveis do estado copiado por store().
+
+			/// Copia as variáveis de um estado para uma linha do buffer.
+			///
+			/// Variáveis além de state_dim() são descartadas e as que faltam são gravadas como 0.
+			/// @param s Estado.
+			/// @param dest Vetor de estados do buffer.
+			/// @param i Índice da transição.
+			void store(const State &s, std::vector<double> &dest, int i);
+
+			/// Grava uma transição em uma posição do buffer.
+			/// @param i Índice da transição.
+			/// @see add()
+			void write(int i, const State &s, const Action &a, double r, const State &next_s, bool terminal, const ActionMask *next_mask);
+
+			/// Encontra uma ação pelo seu número.
+			/// @param actions Ações do ambiente.
+			/// @param num Número da ação.
+			/// @return Ação com o número **num** ou nullptr, caso não exista.
+			static Action *find_action(const std::vector<Action *> &actions, int num);
+
+			/// Atualiza o LinearFA com uma transição usando o alvo do Q-Learning.
+			///
+			/// Quando a transição possui a máscara das ações realizáveis em **s'**, somente essas ações
+			/// são consideradas no máximo de \f$ Q(s',a') \f$.
+			/// @param vfa Aproximador de funções linear.
+			/// @param actions Ações do ambiente, na ordem de Env::action_list().
+			/// @param i Índice da transição.
+			/// @param alpha Taxa de aprendizagem.
+			/// @param gamma Desconto do retorno.
+			/// @return Erro TD \f$ \delta \f$ da transição.
+			double update(LinearFA &vfa, const std::vector<Action *> &actions, int i, double alpha, double gamma);
+
+		public:
+			/// Cria um buffer vazio.
+			/// @param capacity Quantidade máxima de transições.
+			/// @param state_dim Quantidade de variáveis de um estado, como retornado por State::to_vec().
+			ReplayBuffer(int capacity, int state_dim);
+
+			virtual ~ReplayBuffer() { }
+
+			/// Adiciona uma transição em O(1).
+			/// @param s Estado **s**.
+			/// @param a Ação executada.
+			/// @param r Recompensa recebida.
+			/// @param next_s Próximo estado **s'**.
+			/// @param terminal Indica se **s'** é um estado terminal.
+			/// @param next_mask Ações realizáveis em **s'**, como preenchido por Env::applicable_mask(), ou
+			/// nullptr para considerar todas as ações realizáveis.
+			/// @return Índice onde a transição foi gravada.
+			virtual int add(const State &s, const Action &a, double r, const State &next_s, bool terminal,
+							const ActionMask *next_mask = nullptr);
+
+			/// Adiciona uma transição em O(1).
+			/// @param eo Transição retornada por Env::exec_act().
+			/// @return Índice onde a transição foi gravada.
+			int add(const EnvOutcome &eo);
+
+			/// Sorteia transições com distribuição uniforme e com reposição.
+			/// @param batch_size Quantidade de transições sorteadas.
+			/// @param indices Vetor que recebe os índices das transições sorteadas.
+			void sample(int batch_size, std::vector<int> &indices);
+
+			/// Reinicia o gerador de números aleatórios da amostragem.
+			/// @param seed Semente.
+			void seed(uint64_t seed);
+
+			/// Sorteia transições e atualiza o LinearFA com o alvo do Q-Learning
+			/// \f$ r + \gamma \max_{a'} Q(s',a') \f$.
+			/// @param vfa Aproximador de funções linear.
+			/// @param actions Ações do ambiente consideradas no máximo de \f$ Q(s',a') \f$, na ordem de
+			/// Env::action_list(). Transições gravadas com máscara consideram somente as ações realizáveis.
+			/// @param batch_size Quantidade de transições sorteadas.
+			/// @param alpha Taxa de aprendizagem.
+			/// @param gamma Desconto do retorno.
+			virtual void replay(LinearFA &vfa, const std::vector<Action *> &actions, int batch_size, double alpha, double gamma);
+
+			/// Variáveis do estado **s** de uma transição.
+			const double *state(int i) const { return &m_states[i * m_dim]; }
+			/// Variáveis do estado **s'** de uma transição.
+			const double *next_state(int i) const { return &m_next_states[i * m_dim]; }
+			/// Número da ação de uma transição.
+			int action(int i) const { return m_actions[i]; }
+			/// Recompensa de uma transição.
+			double reward(int i) const { return m_rewards[i]; }
+			/// Indica se o estado **s'** de uma transição é terminal.
+			bool terminal(int i) const { return m_terminals[i]; }
+
+			/// Quantidade de transições armazenadas.
+			int size() const { return m_size; }
+			/// Quantidade máxima de transições.
+			int capacity() const { return m_capacity; }
+			/// Quantidade de variáveis de um estado.
+			int state_dim() const { return m_dim; }
+
+			/// Descarta todas as transições.
+			virtual void clear();
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ rlenvadapter.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "rlenvadapter.hpp"
+
+#include <string>
+
+using namespace ia::rl;
+
+RLEnvAdapter::RLEnvAdapter(RLEnv *env, int num_actions, bool check_applicable) :
+    m_env(env), m_check_applicable(check_applicable), m_repeat(1), m_curr(nullptr), m_last_reward(0.)
+{
+    m_actions.reserve(num_actions);
+    for (int i = 0; i < num_actions; i++)
+        m_actions.push_back(Action(std::to_string(i), i));
+}
+
+RLEnvState *RLEnvAdapter::read_state()
+{
+    RLEnvState *s = m_pool.acquire();
+    s->m_vars = m_env->getState(); // moves the returned buffer, no element is copied
+    s->m_has_mask = false;
+    m_curr = s;
+    return s;
+}
+
+State *RLEnvAdapter::curr_obs()
+{
+    return m_curr != nullptr ? m_curr : read_state();
+}
+
+std::vector<Action *> RLEnvAdapter::actions()
+{
+    std::vector<Action *> acts;
+    for (Action &a : m_actions)
+        acts.push_back(&a);
+    return acts;
+}
+
+void RLEnvAdapter::applicable_mask(State *state, ActionMask &mask)
+{
+    int n = m_actions.size();
+    if (!m_check_applicable) {
+        mask.reset(n);
+        for (int i = 0; i < n; i++)
+            mask.set(i);
+        return;
+    }
+
+    RLEnvState *s = static_cast<RLEnvState *>(state);
+    if (!s->m_has_mask) {
+        s->m_mask.reset(n);
+        for (int a : m_env->getApplicableActions(s->m_vars)) {
+            if (a >= 0 && a < n)
+                s->m_mask.set(a);
+        }
+        s->m_has_mask = true;
+    }
+    mask = s->m_mask;
+}
+
+StepOutcome RLEnvAdapter::act_many(const int *actions, int n, int *executed)
+{
+    double r = 0.;
+    int i = 0;
+    while (i < n) {
+        m_env->act(actions[i++]);
+        r += m_env->getReward();
+        if (m_env->isEndEpisode())
+            break;
+    }
+    if (executed != nullptr)
+        *executed = i;
+    m_last_reward = r;
+    return StepOutcome(read_state(), r, m_env->isEndEpisode());
+}
+
+void RLEnvAdapter::release_state(State *s)
+{
+    if (s == m_curr)
+        m_curr = nullptr; // read again by the next curr_obs()
+    m_pool.release(static_cast<RLEnvState *>(s));
+}
+
+EnvOutcome *RLEnvAdapter::exec_act(Action *a)
+{
+    State *o = curr_obs();
+    StepOutcome so = step(a);
+    return new EnvOutcome(o, a, so.m_op, so.m_r, so.m_terminated);
+}
+
+StepOutcome RLEnvAdapter::step(Action *a)
+{
+    if (m_repeat == 1)
+        return act_many(&a->m_num, 1);
+    m_repeated.assign(m_repeat, a->m_num);
+    return act_many(m_repeated.data(), m_repeat);
+}
+
+void RLEnvAdapter::reset_env()
+{
+    m_env->reset();
+    m_last_reward = 0.;
+    m_pool.reset();
+    m_curr = nullptr;
+}
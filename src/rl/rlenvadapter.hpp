@@ -0,0 +1,145 @@
+/*
+ rlenvadapter.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef RLENVADAPTER_H
+#define RLENVADAPTER_H
+
+#include "env.hpp"
+#include "statepool.hpp"
+#include "../rl_env.h"
+
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Estado de um RLEnv, reaproveitado por RLEnvAdapter.
+		class RLEnvState : public State {
+		public:
+			std::vector<double> m_vars; ///< Variáveis retornadas por RLEnv::getState().
+			ActionMask m_mask; ///< Ações realizáveis neste estado, válidas se m_has_mask for **true**.
+			bool m_has_mask; ///< Indica se m_mask já foi calculada.
+
+			/// Cria um estado vazio.
+			RLEnvState() : m_has_mask(false) { }
+
+			std::vector<double> to_vec() const override {
+				return m_vars;
+			}
+
+			/// Copia m_vars sem alocar memória quando **vars** já tem a capacidade necessária.
+			void get_vars(std::vector<double> &vars) const override {
+				vars.assign(m_vars.begin(), m_vars.end());
+			}
+		};
+
+		/// Expõe um RLEnv como um Env, permitindo usá-lo com GDSarsaLambda e os demais agentes.
+		///
+		/// Cada número de ação do RLEnv vira uma Action criada uma única vez, com Action::m_num igual
+		/// ao número. Os estados são RLEnvState de um StatePool: o vetor retornado por
+		/// RLEnv::getState() é movido para o estado, sem cópia dos elementos, e RLEnv::getApplicableActions()
+		/// é consultado no máximo uma vez por estado, já que o resultado fica guardado no próprio estado.
+		///
+		/// act_many() executa várias ações seguidas lendo o estado somente no final. Com
+		/// set_action_repeat(), step() passa a repetir cada ação escolhida pelo agente.
+		/// @note Como um RLEnv não pode ser copiado, clone() não é implementado e
+		/// PolicyEvaluator::evaluate() executa os episódios em sequência no próprio adaptador.
+		/// @see ia::rl::Env ia::rl::StatePool
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// MyLegacyEnv legacy; // Implementa RLEnv com ações de 0 a 3
+		/// ia::rl::RLEnvAdapter env(&legacy, 4);
+		/// ia::rl::GDSarsaLambda gdsl(0.1, 0.9, 0.95, 0.1, 0.01, true, &fa);
+		/// env.reset_env();
+		/// delete gdsl.run_learning(&env, 1000);
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class RLEnvAdapter : public Env {
+		private:
+			RLEnv *m_env; ///< Ambiente adaptado.
+			std::vector<Action> m_actions; ///< Uma ação para cada número de ação do RLEnv.
+			bool m_check_applicable; ///< Consulta RLEnv::getApplicableActions() ou considera todas as ações realizáveis.
+			int m_repeat; ///< Quantidade de vezes que step() executa a ação.
+			StatePool<RLEnvState> m_pool; ///< Estados do episódio corrente.
+			RLEnvState *m_curr; ///< Estado corrente ou nullptr, caso ainda não tenha sido lido.
+			std::vector<int> m_repeated; ///< Ações repetidas por step().
+			double m_last_reward; ///< Soma das recompensas da última chamada de act_many().
+
+			/// Lê o estado corrente do RLEnv para um estado do StatePool.
+			RLEnvState *read_state();
+
+		public:
+			/// Cria um adaptador.
+			/// @param env Ambiente adaptado.
+			/// @param num_actions Quantidade de ações. As ações do RLEnv são os números de 0 a num_actions - 1.
+			/// @param check_applicable Utilize **false** se todas as ações são sempre realizáveis, para
+			/// não consultar RLEnv::getApplicableActions().
+			/// @note A memória do RLEnv não é liberada com a destruição de um objeto RLEnvAdapter.
+			RLEnvAdapter(RLEnv *env, int num_actions, bool check_applicable = true);
+
+			virtual ~RLEnvAdapter() { }
+
+			/// Define quantas vezes step() executa a ação escolhida pelo agente.
+			///
+			/// As recompensas das repetições são somadas e a repetição é interrompida no fim do episódio.
+			/// @param repeat Quantidade de repetições, 1 por padrão.
+			void set_action_repeat(int repeat) {
+				m_repeat = repeat > 1 ? repeat : 1;
+			}
+
+			/// Executa várias ações seguidas, lendo o estado do RLEnv somente após a última.
+			///
+			/// A execução é interrompida se o episódio terminar.
+			/// @param actions Números das ações.
+			/// @param n Quantidade de ações.
+			/// @param executed Recebe a quantidade de ações executadas. Pode ser nullptr.
+			/// @return Estado após a última ação executada, soma das recompensas e fim do episódio.
+			StepOutcome act_many(const int *actions, int n, int *executed = nullptr);
+
+			State *curr_obs() override;
+
+			std::vector<Action *> actions() override;
+
+			void applicable_mask(State *state, ActionMask &mask) override;
+
+			EnvOutcome *exec_act(Action *a) override;
+
+			StepOutcome step(Action *a) override;
+
+			bool pooled_states() override {
+				return true;
+			}
+
+			/// Devolve um estado ao StatePool.
+			/// @param s Estado retornado por curr_obs() ou step().
+			void release_state(State *s) override;
+
+			/// Soma das recompensas da última chamada de step() ou act_many(), igual a StepOutcome::m_r.
+			double last_reward() override {
+				return m_last_reward;
+			}
+
+			bool is_terminal() override {
+				return m_env->isEndEpisode();
+			}
+
+			/// Reinicia o RLEnv e libera todos os estados do episódio anterior.
+			void reset_env() override;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ rng.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "rng.hpp"
+
+using namespace ia::rl;
+
+Rng::Rng(uint64_t seed, int stream)
+{
+    this->seed(seed);
+    for (int i = 0; i < stream; i++)
+        jump();
+}
+
+void Rng::seed(uint64_t seed)
+{
+    // splitmix64 expands the seed so that similar seeds give unrelated states
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        m_s[i] = z ^ (z >> 31);
+    }
+}
+
+void Rng::jump()
+{
+    static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (JUMP[i] & ((uint64_t)1 << b)) {
+                for (int k = 0; k < 4; k++)
+                    s[k] ^= m_s[k];
+            }
+            next();
+        }
+    }
+    for (int k = 0; k < 4; k++)
+        m_s[k] = s[k];
+}
+
+Rng Rng::stream(int i) const
+{
+    Rng rng(*this);
+    for (int k = 0; k < i; k++)
+        rng.jump();
+    return rng;
+}
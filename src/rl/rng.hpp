@@ -0,0 +1,110 @@
+/*
+ rng.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+namespace ia {
+	namespace rl {
+		/// Gerador de números aleatórios xoshiro256**.
+		///
+		/// Rápido, reprodutível a partir de uma semente e com sequências independentes obtidas por
+		/// jump(), que avança o gerador \f$ 2^{128} \f$ números. Cada thread ou agente deve usar a sua
+		/// própria sequência, obtida com stream(). Atende aos requisitos de UniformRandomBitGenerator,
+		/// portanto também pode ser usado com as distribuições de <random>.
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::Rng rng(42); // Semente 42
+		/// ia::rl::Rng r1 = rng.stream(1); // Sequência independente para a thread 1
+		/// double u = r1.uniform(); // Número entre 0 e 1
+		/// int a = r1.uniform_int(4); // Número inteiro entre 0 e 3
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class Rng {
+		protected:
+			uint64_t m_s[4]; ///< Estado do gerador.
+
+			/// Rotação de bits para a esquerda.
+			static uint64_t rotl(uint64_t x, int k) {
+				return (x << k) | (x >> (64 - k));
+			}
+
+		public:
+			typedef uint64_t result_type; ///< Tipo dos números gerados.
+
+			/// Cria um gerador a partir de uma semente.
+			/// @param seed Semente.
+			/// @param stream Número da sequência. O gerador avança stream vezes com jump().
+			Rng(uint64_t seed = 1, int stream = 0);
+
+			/// Reinicia o gerador a partir de uma semente.
+			/// @param seed Semente.
+			void seed(uint64_t seed);
+
+			/// Avança o gerador \f$ 2^{128} \f$ números.
+			void jump();
+
+			/// Cria uma cópia do gerador avançada **i** vezes com jump().
+			/// @param i Número da sequência.
+			/// @return Gerador independente deste para \f$ i > 0 \f$.
+			Rng stream(int i) const;
+
+			/// Próximo número de 64 bits.
+			uint64_t next() {
+				uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+				uint64_t t = m_s[1] << 17;
+				m_s[2] ^= m_s[0];
+				m_s[3] ^= m_s[1];
+				m_s[1] ^= m_s[2];
+				m_s[0] ^= m_s[3];
+				m_s[2] ^= t;
+				m_s[3] = rotl(m_s[3], 45);
+				return result;
+			}
+
+			/// Número uniforme no intervalo \f$ [0,1) \f$.
+			double uniform() {
+				return (next() >> 11) * (1. / 9007199254740992.);
+			}
+
+			/// Número inteiro uniforme no intervalo \f$ [0,n) \f$.
+			/// @param n Quantidade de valores possíveis. Deve ser maior que 0.
+			int uniform_int(int n) {
+				return (int)(((next() >> 32) * (uint64_t)n) >> 32);
+			}
+
+			/// Próximo número de 64 bits, para uso com as distribuições de <random>.
+			uint64_t operator()() {
+				return next();
+			}
+
+			/// Menor número gerado.
+			static constexpr uint64_t min() {
+				return 0;
+			}
+
+			/// Maior número gerado.
+			static constexpr uint64_t max() {
+				return UINT64_MAX;
+			}
+		};
+	}
+}
+
+#endif
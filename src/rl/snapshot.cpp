@@ -0,0 +1,331 @@
+/*
+ snapshot.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "snapshot.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+using namespace ia::rl;
+
+uint32_t Snapshot::checksum(const char *data, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void put(std::vector<char> &out, const void *data, size_t length)
+{
+    out.insert(out.end(), (const char *)data, (const char *)data + length);
+}
+
+static uint64_t begin_section(std::vector<char> &out)
+{
+    out.resize((out.size() + 7) & ~(size_t)7, 0);
+    return out.size();
+}
+
+Snapshot::Snapshot() : m_tilings(nullptr), m_tile_index(nullptr), m_tiles(nullptr), m_action_index(nullptr),
+    m_action_pairs(nullptr), m_weights(nullptr)
+{
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+bool Snapshot::serialize(const LinearFA &lfa, std::vector<char> &out)
+{
+    const CrossProductFeatures &cpf = lfa.m_safeatures;
+    const TileCoding &tc = cpf.m_sfeatures;
+
+    // weights not described by any tiling, e.g. of a TabularQ, could not be restored
+    if (tc.m_tilings.empty() && !lfa.m_weights.empty())
+        return false;
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.m_magic, "DTFA", 4);
+    h.m_version = SnapshotHeader::VERSION;
+    h.m_dim = tc.m_tilings.empty() ? 0 : tc.m_tilings[0].m_widths.size();
+    h.m_num_tilings = tc.m_tilings.size();
+    h.m_tc_feature_id = tc.m_feature_id;
+    h.m_cpf_feature_id = cpf.m_feature_id;
+    h.m_num_actions = cpf.m_num_actions;
+    h.m_num_action_maps = cpf.m_action_features.size();
+    h.m_num_weights = lfa.m_weights.size();
+    h.m_default_weight = lfa.m_default_weight;
+
+    out.assign(sizeof(h), 0);
+
+    h.m_tilings = begin_section(out);
+    for (const Tiling &tiling : tc.m_tilings) {
+        if (tiling.m_widths.size() != h.m_dim)
+            return false;
+        put(out, tiling.m_widths.data(), h.m_dim * sizeof(double));
+        put(out, tiling.m_offset.data(), h.m_dim * sizeof(double));
+        for (int i = 0; i < h.m_dim; i++) {
+            double mask = tiling.m_dim_mask[i] ? 1. : 0.;
+            put(out, &mask, sizeof(double));
+        }
+    }
+
+    h.m_tile_index = begin_section(out);
+    int32_t start = 0;
+    for (const std::map<Tile, int> &tiles : tc.m_state_features) {
+        put(out, &start, sizeof(int32_t));
+        start += tiles.size();
+    }
+    put(out, &start, sizeof(int32_t));
+    h.m_num_tiles = start;
+
+    h.m_tiles = begin_section(out);
+    for (const std::map<Tile, int> &tiles : tc.m_state_features) {
+        for (auto &entry : tiles) {
+            int32_t row[2] = { entry.first.m_hash_code, entry.second };
+            put(out, row, sizeof(row));
+            for (int i = 0; i < h.m_dim; i++) {
+                int32_t coord = i < entry.first.m_tiled_vector.size() ? entry.first.m_tiled_vector[i] : 0;
+                put(out, &coord, sizeof(int32_t));
+            }
+        }
+    }
+
+    h.m_action_index = begin_section(out);
+    start = 0;
+    for (auto &entry : cpf.m_action_features) {
+        int32_t row[2] = { entry.first, start };
+        put(out, row, sizeof(row));
+        start += entry.second.m_features_map.size();
+    }
+    int32_t end[2] = { 0, start };
+    put(out, end, sizeof(end));
+    h.m_num_action_pairs = start;
+
+    h.m_action_pairs = begin_section(out);
+    for (auto &entry : cpf.m_action_features) {
+        for (auto &pair : entry.second.m_features_map) {
+            int32_t row[2] = { pair.first, pair.second };
+            put(out, row, sizeof(row));
+        }
+    }
+
+    h.m_weights = begin_section(out);
+    // weights are always stored as double, whatever the precision of the LinearFA
+    for (int i = 0; i < lfa.m_weights.size(); i++) {
+        double w = lfa.m_weights[i];
+        put(out, &w, sizeof(double));
+    }
+
+    h.m_length = out.size();
+    h.m_checksum = checksum(out.data() + sizeof(h), out.size() - sizeof(h));
+    memcpy(out.data(), &h, sizeof(h));
+    return true;
+}
+
+bool Snapshot::save(const LinearFA &lfa, const char *path)
+{
+    std::vector<char> out;
+    if (!serialize(lfa, out))
+        return false;
+
+    FILE *f = fopen(path, "wb");
+    if (f == nullptr)
+        return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    return fclose(f) == 0 && ok;
+}
+
+bool Snapshot::open(const char *path, bool verify)
+{
+    close();
+
+    if (!m_file.open(path) || m_file.size() < sizeof(SnapshotHeader)) {
+        close();
+        return false;
+    }
+    const char *data = m_file.data();
+    SnapshotHeader &h = m_header;
+    memcpy(&h, data, sizeof(h));
+
+    // every section must fit in the file before any pointer into it is used
+    bool valid = memcmp(h.m_magic, "DTFA", 4) == 0 && h.m_version == SnapshotHeader::VERSION &&
+        h.m_length == m_file.size() && h.m_dim >= 0 && h.m_num_tilings >= 0 && h.m_num_tiles >= 0 &&
+        h.m_num_action_maps >= 0 && h.m_num_action_pairs >= 0 && h.m_num_weights >= 0 &&
+        h.m_tilings + (uint64_t)h.m_num_tilings * 3 * h.m_dim * sizeof(double) <= h.m_length &&
+        h.m_tile_index + (uint64_t)(h.m_num_tilings + 1) * sizeof(int32_t) <= h.m_length &&
+        h.m_tiles + (uint64_t)h.m_num_tiles * (2 + h.m_dim) * sizeof(int32_t) <= h.m_length &&
+        h.m_action_index + (uint64_t)(h.m_num_action_maps + 1) * 2 * sizeof(int32_t) <= h.m_length &&
+        h.m_action_pairs + (uint64_t)h.m_num_action_pairs * 2 * sizeof(int32_t) <= h.m_length &&
+        h.m_weights + (uint64_t)h.m_num_weights * sizeof(double) <= h.m_length &&
+        (!verify || checksum(data + sizeof(h), h.m_length - sizeof(h)) == h.m_checksum);
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    m_tilings = (const double *)(data + h.m_tilings);
+    m_tile_index = (const int32_t *)(data + h.m_tile_index);
+    m_tiles = (const int32_t *)(data + h.m_tiles);
+    m_action_index = (const int32_t *)(data + h.m_action_index);
+    m_action_pairs = (const int32_t *)(data + h.m_action_pairs);
+    m_weights = (const double *)(data + h.m_weights);
+
+    for (int t = 0; t < h.m_num_tilings; t++) {
+        if (m_tile_index[t] < 0 || m_tile_index[t] > m_tile_index[t + 1] || m_tile_index[t + 1] > h.m_num_tiles) {
+            close();
+            return false;
+        }
+    }
+    for (int a = 0; a < h.m_num_action_maps; a++) {
+        if (m_action_index[2 * a + 1] < 0 || m_action_index[2 * a + 1] > m_action_index[2 * a + 3] ||
+            m_action_index[2 * a + 3] > h.m_num_action_pairs) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void Snapshot::close()
+{
+    m_file.close();
+    memset(&m_header, 0, sizeof(m_header));
+    m_tilings = nullptr;
+    m_tile_index = nullptr;
+    m_tiles = nullptr;
+    m_action_index = nullptr;
+    m_action_pairs = nullptr;
+    m_weights = nullptr;
+}
+
+bool Snapshot::load(LinearFA &lfa) const
+{
+    if (!is_open())
+        return false;
+
+    const SnapshotHeader &h = m_header;
+    lfa = LinearFA();
+    CrossProductFeatures &cpf = lfa.m_safeatures;
+    TileCoding &tc = cpf.m_sfeatures;
+
+    tc.m_feature_id = h.m_tc_feature_id;
+    for (int t = 0; t < h.m_num_tilings; t++) {
+        const double *row = m_tilings + 3 * h.m_dim * t;
+        std::vector<double> widths(row, row + h.m_dim);
+        std::vector<double> offset(row + h.m_dim, row + 2 * h.m_dim);
+        std::vector<bool> dim_mask(h.m_dim);
+        for (int i = 0; i < h.m_dim; i++)
+            dim_mask[i] = row[2 * h.m_dim + i] != 0.;
+        tc.m_tilings.push_back(Tiling(widths, offset, dim_mask));
+
+        // entries are sorted, so each insertion is amortized O(1)
+        std::map<Tile, int> tiles;
+        for (int k = m_tile_index[t]; k < m_tile_index[t + 1]; k++) {
+            const int32_t *entry = m_tiles + (2 + h.m_dim) * k;
+            Tile tile;
+            tile.m_hash_code = entry[0];
+            tile.m_tiled_vector.assign(entry + 2, entry + 2 + h.m_dim);
+            tiles.emplace_hint(tiles.end(), tile, entry[1]);
+        }
+        tc.m_state_features.push_back(tiles);
+    }
+
+    cpf.m_feature_id = h.m_cpf_feature_id;
+    cpf.m_num_actions = h.m_num_actions;
+    for (int a = 0; a < h.m_num_action_maps; a++) {
+        FeaturesMap fm;
+        for (int k = m_action_index[2 * a + 1]; k < m_action_index[2 * a + 3]; k++)
+            fm.m_features_map.emplace_hint(fm.m_features_map.end(), m_action_pairs[2 * k], m_action_pairs[2 * k + 1]);
+        cpf.m_action_features.emplace_hint(cpf.m_action_features.end(), m_action_index[2 * a], fm);
+    }
+
+    lfa.m_default_weight = h.m_default_weight;
+    lfa.m_weights.assign(m_weights, m_weights + h.m_num_weights);
+    return true;
+}
+
+int Snapshot::find_tile(int tiling, const std::vector<double> &input) const
+{
+    // same tile and hash code as Tiling::get_tile()
+    const double *row = m_tilings + 3 * m_header.m_dim * tiling;
+    int hash = 0;
+    int n = input.size() < m_header.m_dim ? input.size() : m_header.m_dim;
+    for (int i = 0; i < n; i++) {
+        if (row[2 * m_header.m_dim + i] != 0.)
+            hash = 31 * hash + (int)floor((input[i] - row[m_header.m_dim + i]) / row[i]);
+    }
+
+    int stride = 2 + m_header.m_dim;
+    int lo = m_tile_index[tiling], hi = m_tile_index[tiling + 1];
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int key = m_tiles[stride * mid];
+        if (key == hash)
+            return m_tiles[stride * mid + 1];
+        if (key < hash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return -1;
+}
+
+int Snapshot::find_action_feature(int action, int from) const
+{
+    if (m_header.m_num_actions > 0)
+        return from * m_header.m_num_actions + action;
+
+    int lo = 0, hi = m_header.m_num_action_maps;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (m_action_index[2 * mid] < action)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == m_header.m_num_action_maps || m_action_index[2 * lo] != action)
+        return -1;
+
+    int begin = m_action_index[2 * lo + 1], end = m_action_index[2 * lo + 3];
+    while (begin < end) {
+        int mid = (begin + end) / 2;
+        if (m_action_pairs[2 * mid] < from)
+            begin = mid + 1;
+        else
+            end = mid;
+    }
+    if (begin == m_action_index[2 * lo + 3] || m_action_pairs[2 * begin] != from)
+        return -1;
+    return m_action_pairs[2 * begin + 1];
+}
+
+void Snapshot::lookup_all(const std::vector<double> &input, const std::vector<Action *> &actions, std::vector<double> &q) const
+{
+    q.assign(actions.size(), 0.);
+    for (int t = 0; t < m_header.m_num_tilings; t++) {
+        int from = find_tile(t, input);
+        if (from < 0)
+            continue;
+        for (int i = 0; i < actions.size(); i++) {
+            int id = find_action_feature(actions[i]->m_num, from);
+            q[i] += id >= 0 && id < m_header.m_num_weights ? m_weights[id] : m_header.m_default_weight;
+        }
+    }
+}
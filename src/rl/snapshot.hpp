@@ -0,0 +1,172 @@
+/*
+ snapshot.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "linearfa.hpp"
+#include "mappedfile.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace ia {
+	namespace rl {
+		/// Cabeçalho de um snapshot binário de LinearFA.
+		///
+		/// Após o cabeçalho, o arquivo contém as seções abaixo, cada uma alinhada em 8 bytes e
+		/// localizada pelo seu deslocamento em bytes a partir do início do arquivo:
+		/// - m_tilings: para cada tiling, larguras, deslocamentos e máscara (1 ou 0) das m_dim dimensões (double);
+		/// - m_tile_index: m_num_tilings + 1 posições (int32_t) do primeiro tile de cada tiling em m_tiles;
+		/// - m_tiles: código hash, id e as m_dim coordenadas de cada tile (int32_t), ordenados pelo código hash;
+		/// - m_action_index: número da ação e posição do primeiro par em m_action_pairs (int32_t) de
+		///   cada ação, seguidos de um par final com a quantidade total de pares;
+		/// - m_action_pairs: id do estado e id do par \f$ (s,a) \f$ (int32_t), ordenados pelo id do estado;
+		/// - m_weights: peso de cada parâmetro livre (double).
+		///
+		/// Os números são gravados na ordem de bytes da máquina que criou o arquivo. m_checksum é o
+		/// FNV-1a de todos os bytes após o cabeçalho.
+		/// @see ia::rl::Snapshot
+		struct SnapshotHeader {
+			char m_magic[4]; ///< Identificação do arquivo: "DTFA".
+			uint32_t m_version; ///< Versão do formato.
+			uint32_t m_checksum; ///< FNV-1a dos bytes após o cabeçalho.
+			int32_t m_dim; ///< Quantidade de variáveis de um estado.
+			int32_t m_num_tilings; ///< Quantidade de tilings.
+			int32_t m_tc_feature_id; ///< Contador de parâmetros livres do TileCoding.
+			int32_t m_cpf_feature_id; ///< Contador de parâmetros livres do CrossProductFeatures.
+			int32_t m_num_actions; ///< Quantidade de ações do mapeamento aritmético ou 0.
+			int32_t m_num_action_maps; ///< Quantidade de ações em m_action_index.
+			int32_t m_num_tiles; ///< Quantidade de tiles em m_tiles.
+			int32_t m_num_action_pairs; ///< Quantidade de pares em m_action_pairs.
+			int32_t m_num_weights; ///< Quantidade de pesos.
+			double m_default_weight; ///< Peso inicial dos parâmetros livres.
+			uint64_t m_length; ///< Tamanho do arquivo em bytes.
+			uint64_t m_tilings; ///< Deslocamento da seção dos tilings.
+			uint64_t m_tile_index; ///< Deslocamento da seção de índices dos tiles.
+			uint64_t m_tiles; ///< Deslocamento da seção dos tiles.
+			uint64_t m_action_index; ///< Deslocamento da seção de índices das ações.
+			uint64_t m_action_pairs; ///< Deslocamento da seção dos pares \f$ (s,a) \f$.
+			uint64_t m_weights; ///< Deslocamento da seção dos pesos.
+
+			static const uint32_t VERSION = 1; ///< Versão atual do formato.
+		};
+
+		/// Snapshot binário de um LinearFA, carregado sem nenhuma interpretação de texto.
+		///
+		/// save() grava o TileCoding, o CrossProductFeatures e os pesos em vetores contíguos. open()
+		/// mapeia o arquivo com MappedFile e valida o cabeçalho e o checksum. Em seguida, lookup_all()
+		/// consulta os valores **Q** diretamente do arquivo mapeado, e load() reconstrói um LinearFA
+		/// completo para continuar a aprendizagem.
+		/// @see ia::rl::SnapshotHeader ia::rl::LinearFA
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::Snapshot::save(*gdsl.m_vfa, "motor_ctrl.snap"); // Salva o treinamento
+		///
+		/// ia::rl::Snapshot snap;
+		/// if (snap.open("motor_ctrl.snap")) {
+		///     std::vector<double> q;
+		///     snap.lookup_all(s->to_vec(), env->actions(), q); // Valores Q sem criar o LinearFA
+		/// }
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class Snapshot {
+		protected:
+			MappedFile m_file; ///< Arquivo aberto.
+			SnapshotHeader m_header; ///< Cabeçalho do arquivo aberto.
+
+			const double *m_tilings; ///< Larguras, deslocamentos e máscaras dos tilings.
+			const int32_t *m_tile_index; ///< Posição do primeiro tile de cada tiling.
+			const int32_t *m_tiles; ///< Código hash, id e coordenadas dos tiles.
+			const int32_t *m_action_index; ///< Número da ação e posição do primeiro par de cada ação.
+			const int32_t *m_action_pairs; ///< Pares (id do estado, id do par \f$ (s,a) \f$).
+			const double *m_weights; ///< Pesos dos parâmetros livres.
+
+			/// Encontra o id do tile ativado pela entrada em um tiling.
+			/// @return Id do tile ou -1, caso ele não exista.
+			int find_tile(int tiling, const std::vector<double> &input) const;
+
+			/// Encontra o id de um par \f$ (s,a) \f$.
+			/// @return Id do par ou -1, caso ele não exista.
+			int find_action_feature(int action, int from) const;
+
+		public:
+			/// Cria um Snapshot sem nenhum arquivo aberto.
+			Snapshot();
+
+			virtual ~Snapshot() { }
+
+			/// Gera o conteúdo de um snapshot binário de um LinearFA.
+			/// @param lfa Aproximador de funções linear.
+			/// @param out Recebe o conteúdo do arquivo.
+			/// @return **True** se todos os tilings têm a mesma quantidade de dimensões ou **false**, caso
+			/// contrário ou se há pesos sem nenhum tiling, como em um TabularQ.
+			static bool serialize(const LinearFA &lfa, std::vector<char> &out);
+
+			/// Checksum FNV-1a utilizado pelo snapshot.
+			/// @param data Dados.
+			/// @param length Tamanho dos dados em bytes.
+			static uint32_t checksum(const char *data, size_t length);
+
+			/// Grava um snapshot binário de um LinearFA.
+			/// @param lfa Aproximador de funções linear.
+			/// @param path Caminho do arquivo, substituído caso exista.
+			/// @return **True** se o arquivo foi gravado ou **false**, caso contrário.
+			static bool save(const LinearFA &lfa, const char *path);
+
+			/// Abre um snapshot binário.
+			/// @param path Caminho do arquivo.
+			/// @param verify Calcula o checksum de todo o arquivo.
+			/// @return **True** se o arquivo é um snapshot válido ou **false**, caso contrário.
+			bool open(const char *path, bool verify = true);
+
+			/// Fecha o arquivo aberto.
+			void close();
+
+			/// Reconstrói um LinearFA a partir do snapshot aberto.
+			/// @param lfa Recebe o TileCoding, o CrossProductFeatures e os pesos do snapshot.
+			/// @return **True** se um snapshot está aberto ou **false**, caso contrário.
+			bool load(LinearFA &lfa) const;
+
+			/// Calcula o valor **Q** de várias ações diretamente do arquivo mapeado.
+			///
+			/// Equivalente a LinearFA::lookup_all(): tiles inexistentes são ignorados e pares
+			/// \f$ (s,a) \f$ inexistentes usam o peso inicial.
+			/// @param input Variáveis do estado, como retornado por State::to_vec().
+			/// @param actions Ações avaliadas.
+			/// @param q Recebe o valor de cada ação, na mesma ordem de **actions**.
+			void lookup_all(const std::vector<double> &input, const std::vector<Action *> &actions, std::vector<double> &q) const;
+
+			/// Indica se um snapshot está aberto.
+			bool is_open() const {
+				return m_file.data() != nullptr;
+			}
+
+			/// Cabeçalho do snapshot aberto.
+			const SnapshotHeader &header() const {
+				return m_header;
+			}
+
+			/// Quantidade de pesos do snapshot aberto.
+			int num_weights() const {
+				return m_header.m_num_weights;
+			}
+		};
+	}
+}
+
+#endif
@@ -35,6 +35,15 @@ namespace ia {
 			/// Obtém um vetor com todas as variáveis do ambiente.
 			/// @return Vetor com todas as variáveis do ambiente.
 			virtual std::vector<double> to_vec() const = 0;
+
+			/// Copia todas as variáveis do ambiente para um vetor existente.
+			///
+			/// A implementação padrão copia o resultado de to_vec(). Sobrescreva para preencher **vars**
+			/// sem alocar memória quando sua capacidade já é suficiente.
+			/// @param vars Vetor que recebe as variáveis do ambiente.
+			virtual void get_vars(std::vector<double> &vars) const {
+				vars = to_vec();
+			}
 			
 			/// Compara dois estados.
 			bool operator ==(const State &other) const {
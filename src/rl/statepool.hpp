@@ -0,0 +1,113 @@
+/*
+ statepool.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef STATEPOOL_H
+#define STATEPOOL_H
+
+#include <deque>
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Conjunto de estados reaproveitáveis de um ambiente.
+		///
+		/// Os objetos são criados somente quando o conjunto não tem nenhum objeto livre e nunca
+		/// mudam de endereço. release() devolve um objeto ao conjunto e reset() devolve todos de uma
+		/// vez, de modo que a quantidade de objetos criados é limitada pela quantidade de estados em
+		/// uso ao mesmo tempo, e não pelo tamanho dos episódios.
+		///
+		/// Um ambiente que utiliza um StatePool deve sobrescrever Env::pooled_states() para retornar
+		/// **true** e Env::release_state() para chamar release(). Os estados permanecem válidos até
+		/// serem liberados ou até a próxima chamada de reset(), normalmente feita em Env::reset_env().
+		/// @tparam T Classe derivada de State que pode ser construída sem argumentos.
+		/// @see ia::rl::Env::pooled_states()
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// class MyEnv : public ia::rl::Env {
+		///     ia::rl::StatePool<MyState> m_pool;
+		/// public:
+		///     bool pooled_states() { return true; }
+		///     void release_state(ia::rl::State *s) { m_pool.release(static_cast<MyState *>(s)); }
+		///     void reset_env() { m_pool.reset(); ... }
+		///     ia::rl::StepOutcome step(ia::rl::Action *a) {
+		///         MyState *s = m_pool.acquire();
+		///         ... // atualiza as variáveis de s
+		///         return ia::rl::StepOutcome(s, r, terminated);
+		///     }
+		/// };
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		template <class T>
+		class StatePool {
+		protected:
+			std::deque<T> m_objects; ///< Objetos do conjunto, livres ou em uso.
+			std::vector<T *> m_free; ///< Objetos devolvidos por release().
+			int m_next; ///< Objetos de m_objects a partir deste índice estão livres desde o último reset().
+			int m_used; ///< Quantidade de objetos em uso.
+
+		public:
+			/// Cria um conjunto vazio.
+			StatePool() : m_next(0), m_used(0) { }
+
+			/// Retorna um objeto livre, criando um novo caso necessário.
+			/// @return Objeto livre. Suas variáveis mantêm os valores do último uso.
+			T *acquire() {
+				T *obj;
+				if (!m_free.empty()) {
+					obj = m_free.back();
+					m_free.pop_back();
+				} else {
+					if (m_next == (int)m_objects.size()) {
+						m_objects.emplace_back();
+						m_free.reserve(m_objects.size()); // release() never allocates
+					}
+					obj = &m_objects[m_next++];
+				}
+				m_used++;
+				return obj;
+			}
+
+			/// Devolve ao conjunto um objeto retornado por acquire(), sem destruí-lo.
+			/// @param obj Objeto em uso.
+			void release(T *obj) {
+				m_free.push_back(obj);
+				m_used--;
+			}
+
+			/// Libera todos os objetos do conjunto sem destruí-los.
+			void reset() {
+				m_free.clear();
+				m_next = 0;
+				m_used = 0;
+			}
+
+			/// Quantidade de objetos em uso.
+			/// @return Quantidade de objetos em uso.
+			int size() const {
+				return m_used;
+			}
+
+			/// Quantidade de objetos criados.
+			/// @return Quantidade de objetos criados.
+			int capacity() const {
+				return m_objects.size();
+			}
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ tabularq.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "tabularq.hpp"
+
+using namespace ia::rl;
+
+TabularQ::TabularQ(const Discretizer *discretizer, int num_actions, double default_weight) :
+    m_discretizer(discretizer), m_num_actions(num_actions)
+{
+    m_default_weight = default_weight;
+    m_weights.resize(discretizer->num_states() * num_actions, default_weight);
+}
+
+void TabularQ::features(State *s, Action *a, std::vector<StateFeature> &features)
+{
+    features.clear();
+    features.push_back(StateFeature(m_discretizer->index(*s) * m_num_actions + a->m_num, 1.));
+}
+
+void TabularQ::evaluate_all(State &s, const std::vector<Action *> &actions, std::vector<double> &q, std::vector<StateFeature> &)
+{
+    int row = m_discretizer->index(s) * m_num_actions;
+    q.resize(actions.size());
+    for (int i = 0; i < actions.size(); i++)
+        q[i] = m_weights[row + actions[i]->m_num];
+}
+
+void TabularQ::evaluate_batch(const std::vector<State *> &states, const std::vector<std::vector<Action *>> &actions,
+                              std::vector<std::vector<double>> &q, std::vector<std::vector<StateFeature>> &features)
+{
+    for (int i = 0; i < states.size(); i++) {
+        if (states[i] != nullptr)
+            evaluate_all(*states[i], actions[i], q[i], features[i]);
+    }
+}
+
+void TabularQ::lookup_all(const std::vector<double> &input, const std::vector<Action *> &actions, std::vector<double> &q,
+                          Tile &, std::vector<StateFeature> &) const
+{
+    int row = m_discretizer->index(input) * m_num_actions;
+    q.resize(actions.size());
+    for (int i = 0; i < actions.size(); i++)
+        q[i] = m_weights[row + actions[i]->m_num];
+}
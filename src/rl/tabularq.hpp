@@ -0,0 +1,91 @@
+/*
+ tabularq.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef TABULARQ_H
+#define TABULARQ_H
+
+#include "linearfa.hpp"
+#include "discretizer.hpp"
+
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Tabela de valores **Q** para espaços de estados pequenos e discretos.
+		///
+		/// Substitui o LinearFA nos agentes quando não há necessidade de generalização: cada par
+		/// \f$ (s,a) \f$ tem um único parâmetro livre, de id \f$ s \cdot num\_actions + a \f$, onde
+		/// **s** é o índice dado pelo Discretizer e **a** é Action::m_num. Os pesos ficam em um vetor
+		/// contíguo [estado][ação] alocado na construção, sem TileCoding nem mapas. Como o gradiente
+		/// continua sendo um StateFeature, traços de elegibilidade e atualizações de GDSarsaLambda,
+		/// TrueOnlineSarsaLambda e dos demais agentes funcionam sem alteração.
+		/// @see ia::rl::Discretizer ia::rl::LinearFA
+		/// @note Os números das ações, Action::m_num, devem estar entre 0 e num_actions - 1.
+		/// @note Como não há TileCoding, Snapshot, Checkpoint e PolicyCompiler recusam um TabularQ.
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::GridDiscretizer grid(min, max, bins);
+		/// ia::rl::TabularQ table(&grid, 4); // 4 ações
+		/// ia::rl::GDSarsaLambda gdsl(0.1, 0.9, 0.95, 0.1, 0.01, true, &table);
+		/// gdsl.run_learning(env, 100);
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class TabularQ : public LinearFA {
+		private:
+			const Discretizer *m_discretizer; ///< Índice de cada estado.
+			int m_num_actions; ///< Quantidade de ações.
+
+		public:
+			/// Cria uma tabela de valores **Q**.
+			/// @param discretizer Índice de cada estado.
+			/// @param num_actions Quantidade de ações.
+			/// @param default_weight Valor inicial de todos os pares \f$ (s,a) \f$.
+			/// @note A memória do Discretizer não é liberada com a destruição de um objeto TabularQ.
+			TabularQ(const Discretizer *discretizer, int num_actions, double default_weight = 0.);
+
+			virtual ~TabularQ() { }
+
+			LinearFA *clone() const override {
+				return new TabularQ(*this);
+			}
+
+			/// Quantidade de ações.
+			int num_actions() const {
+				return m_num_actions;
+			}
+
+			/// Valor \f$ Q(s,a) \f$ a partir do índice do estado e do número da ação.
+			double value(int state, int action) const {
+				return m_weights[state * m_num_actions + action];
+			}
+
+			void features(State *s, Action *a, std::vector<StateFeature> &features) override;
+
+			void evaluate_all(State &s, const std::vector<Action *> &actions, std::vector<double> &q, std::vector<StateFeature> &features) override;
+
+			void evaluate_batch(const std::vector<State *> &states, const std::vector<std::vector<Action *>> &actions,
+			                    std::vector<std::vector<double>> &q, std::vector<std::vector<StateFeature>> &features) override;
+
+			void lookup_all(const std::vector<double> &input, const std::vector<Action *> &actions, std::vector<double> &q,
+			                Tile &tile, std::vector<StateFeature> &features) const override;
+
+			using LinearFA::evaluate_all;
+		};
+	}
+}
+
+#endif
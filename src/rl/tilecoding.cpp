@@ -19,12 +19,6 @@
 
 using namespace ia::rl;
 
-StateFeature::StateFeature() {}
-
-StateFeature::StateFeature(int id, double value) : m_id(id), m_value(value) {}
-
-StateFeature::StateFeature(const StateFeature &state_feature) : m_id(state_feature.m_id), m_value(state_feature.m_value) {}
-
 Tile::Tile() {}
 
 Tile::Tile(std::vector<int> &tiled_vector, std::vector<bool> &dim_mask) : m_tiled_vector(tiled_vector)
@@ -79,20 +73,99 @@ Tile Tiling::get_tile(std::vector<double> input)
     return Tile(tiled_vector, m_dim_mask);
 }
 
-int TileCoding::get_or_gen_feature(std::map<Tile, int> &tile_map, Tile &tile)
+void Tiling::get_tile(const std::vector<double> &input, Tile &tile) const
 {
-    int stored;
-    if (tile_map.find(tile) == tile_map.end())
+    tile.m_tiled_vector.resize(input.size());
+    tile.m_hash_code = 0;
+    for (int i = 0; i < input.size(); i++)
     {
-        stored = m_feature_id++;
-        tile_map[tile] = stored;
+        if (m_dim_mask[i]) {
+            tile.m_tiled_vector[i] = (int)floor((input[i] - m_offset[i]) / m_widths[i]);
+            tile.m_hash_code = 31 * tile.m_hash_code + tile.m_tiled_vector[i];
+        }
+        else
+            tile.m_tiled_vector[i] = 0;
+    }
+}
+
+int TileCoding::get_or_gen_feature(int tiling, Tile &tile)
+{
+    std::map<Tile, int> &tile_map = m_state_features[tiling];
+    auto it = tile_map.find(tile);
+    if (it != tile_map.end()) {
+        if (m_max_features > 0) {
+            m_referenced[it->second] = 1;
+            m_pinned[it->second] = m_epoch;
+        }
+        return it->second;
+    }
+
+    int stored;
+    if (m_max_features > 0 && m_feature_id >= m_max_features) {
+        stored = evict();
+        m_recycled.push_back(stored);
     }
     else
-        stored = tile_map[tile];
+        stored = m_feature_id++;
+    tile_map.emplace(tile, stored);
 
+    if (m_max_features > 0) {
+        m_referenced[stored] = 1;
+        m_pinned[stored] = m_epoch;
+        m_owners[stored] = std::make_pair(tiling, tile.m_hash_code);
+    }
     return stored;
 }
 
+int TileCoding::evict()
+{
+    // ids of the current features() call are skipped, so a state never gets one id twice
+    while (m_referenced[m_hand] || m_pinned[m_hand] == m_epoch) {
+        m_referenced[m_hand] = 0;
+        m_hand = (m_hand + 1) % m_max_features;
+    }
+    int victim = m_hand;
+    m_hand = (m_hand + 1) % m_max_features;
+
+    // tiles are ordered by hash code only, so a key with the same hash finds the owner
+    Tile key;
+    key.m_hash_code = m_owners[victim].second;
+    m_state_features[m_owners[victim].first].erase(key);
+    m_evictions++;
+    return victim;
+}
+
+bool TileCoding::set_budget(int max_features)
+{
+    if (max_features > 0 && max_features < (int)m_tilings.size())
+        return false;
+    if (max_features > 0 && max_features < m_feature_id)
+        max_features = m_feature_id;
+    m_max_features = max_features;
+    m_hand = 0;
+    if (max_features <= 0) {
+        std::vector<char>().swap(m_referenced);
+        std::vector<std::pair<int, int>>().swap(m_owners);
+        std::vector<unsigned int>().swap(m_pinned);
+        return true;
+    }
+
+    m_referenced.assign(max_features, 0);
+    m_pinned.assign(max_features, m_epoch);
+    m_owners.assign(max_features, std::make_pair(0, 0));
+    for (int i = 0; i < m_state_features.size(); i++) {
+        for (auto &entry : m_state_features[i])
+            m_owners[entry.second] = std::make_pair(i, entry.first.m_hash_code);
+    }
+    return true;
+}
+
+void TileCoding::take_recycled(std::vector<int> &ids)
+{
+    ids.swap(m_recycled);
+    m_recycled.clear();
+}
+
 std::vector<double> TileCoding::rand_offset(std::vector<bool> &dim_mask, std::vector<double> &widths)
 {
     std::vector<double> offset(dim_mask.size());
@@ -100,17 +173,24 @@ std::vector<double> TileCoding::rand_offset(std::vector<bool> &dim_mask, std::ve
     for (int i = 0; i < offset.size(); i++)
     {
         if (dim_mask[i])
-            offset[i] = m_distribution(m_gen) * widths[i];
+            offset[i] = m_rng.uniform() * widths[i];
         else
             offset[i] = 0.;
     }
     return offset;
 }
 
-TileCoding::TileCoding() : m_distribution(0, 1), m_feature_id(0) {}
+TileCoding::TileCoding() : m_feature_id(0), m_track_new(false), m_max_features(0), m_hand(0), m_epoch(0), m_evictions(0) {}
 
 TileCoding::TileCoding(const TileCoding &tile_coding) : m_feature_id(tile_coding.m_feature_id), m_tilings(tile_coding.m_tilings), m_state_features(tile_coding.m_state_features),
-                                            m_gen(tile_coding.m_gen), m_distribution(tile_coding.m_distribution) {}
+                                            m_rng(tile_coding.m_rng), m_track_new(false), m_max_features(tile_coding.m_max_features),
+                                            m_referenced(tile_coding.m_referenced), m_owners(tile_coding.m_owners), m_hand(tile_coding.m_hand),
+                                            m_epoch(tile_coding.m_epoch), m_pinned(tile_coding.m_pinned), m_evictions(tile_coding.m_evictions), m_recycled(tile_coding.m_recycled) {}
+
+void TileCoding::seed(uint64_t seed)
+{
+    m_rng.seed(seed);
+}
 
 void TileCoding::add_tiling(std::vector<bool> &dim_mask, std::vector<double> &widths, int num_tilings)
 {
@@ -124,16 +204,38 @@ void TileCoding::add_tiling(std::vector<bool> &dim_mask, std::vector<double> &wi
 
 std::vector<StateFeature> TileCoding::features(ia::rl::State *s)
 {
-    std::vector<double> input = s->to_vec();
     std::vector<StateFeature> features;
+    this->features(s, features);
+    return features;
+}
+
+void TileCoding::features(ia::rl::State *s, std::vector<StateFeature> &features)
+{
+    // the work vectors keep their capacity, so known tiles are found without allocating
+    s->get_vars(m_input);
+    features.clear();
+    m_epoch++;
     for (int i = 0; i < m_tilings.size(); i++)
     {
-        Tile tile = m_tilings[i].get_tile(input);
-        int f = get_or_gen_feature(m_state_features[i], tile);
-        StateFeature sf(f, 1.);
-        features.push_back(sf);
+        m_tilings[i].get_tile(m_input, m_tile);
+        int before = m_feature_id;
+        int f = get_or_gen_feature(i, m_tile);
+        if (m_track_new && m_feature_id != before)
+            m_new_tiles.push_back(std::make_pair(i, m_tile));
+        features.push_back(StateFeature(f, 1.));
+    }
+}
+
+void TileCoding::find_features(const std::vector<double> &input, Tile &tile, std::vector<StateFeature> &features) const
+{
+    features.clear();
+    for (int i = 0; i < m_tilings.size(); i++)
+    {
+        m_tilings[i].get_tile(input, tile);
+        auto it = m_state_features[i].find(tile);
+        if (it != m_state_features[i].end())
+            features.push_back(StateFeature(it->second, 1.));
     }
-    return features;
 }
 
 int TileCoding::num_features()
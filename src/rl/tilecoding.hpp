@@ -19,10 +19,10 @@
 #define TILECODING_H
 
 #include "state.hpp"
+#include "rng.hpp"
 
 #include <math.h>
 #include <vector>
-#include <random>
 #include <map>
 #include <string>
 
@@ -35,25 +35,19 @@ namespace ia {
 		///
 		/// Cada parâmetro livre possui um id e um valor que
 		/// indica sua influência na representação de um estado do ambiente.
+		/// StateFeature é um tipo POD e pode ser copiado sem custo adicional.
 		class StateFeature {
 		public:
 			int m_id; ///< Id do parâmetro livre.
 			double m_value; ///< Influência do parâmetro livre. Sempre 1 para o algoritmo TileCoding.
 
 			/// Cria um StateFeature.
-			StateFeature();
+			StateFeature() = default;
 
 			/// Cria um StateFeature com id e influência.
 			/// @param id Id do parâmetro livre.
 			/// @param value Influência do parâmetro livre.
-			StateFeature(int id, double value);
-
-			/// Cria um StateFeature a partir de outro StateFeature.
-            ///
-            /// Este construtor cria uma cópia completa de um outro StateFeature.
-			StateFeature(const StateFeature &state_feature);
-
-			virtual ~StateFeature() { }
+			StateFeature(int id, double value) : m_id(id), m_value(value) { }
 
 			/// Carrega os parâmetros livres de um LinearFA.
 			/// @note Não utilize este operador em StateFeature, ao invés disto,
@@ -81,6 +75,29 @@ namespace ia {
 			}
 		};
 
+		/// Sequência de parâmetros livres que não é dona da memória apontada.
+		///
+		/// Os dados pertencem ao objeto que criou a sequência e só são válidos
+		/// até a próxima chamada que modifica esse objeto.
+		/// @see LinearFA::gradient()
+		class FeatureSpan {
+		public:
+			const StateFeature *m_data; ///< Primeiro parâmetro livre.
+			int m_size; ///< Quantidade de parâmetros livres.
+
+			/// Cria uma sequência vazia.
+			FeatureSpan() : m_data(nullptr), m_size(0) { }
+
+			/// Cria uma sequência a partir de um vetor de parâmetros livres.
+			/// @param features Vetor com os parâmetros livres.
+			FeatureSpan(const std::vector<StateFeature> &features) : m_data(features.data()), m_size(features.size()) { }
+
+			const StateFeature *begin() const { return m_data; }
+			const StateFeature *end() const { return m_data + m_size; }
+			int size() const { return m_size; }
+			const StateFeature &operator[](int i) const { return m_data[i]; }
+		};
+
 		/// Define a estrutura de um Tile.
 		///
 		/// Ao criar um TileCode deve-se configurar as dimensões dos tiles que compõem um tiling.
@@ -88,6 +105,12 @@ namespace ia {
 		/// acontece com um deslocamento definido na classe TileCode e armazenado em Tiling.
 		/// @see ia::rl::Tiling ia::rl::TileCode
 		class Tile {
+			friend class Tiling;
+			friend class TileCoding;
+			friend class Snapshot;
+			friend class Checkpoint;
+			friend class FixedTileCoding;
+
 		protected:
 			int m_hash_code; ///< Código hash.
 
@@ -164,6 +187,11 @@ namespace ia {
 		/// varios Tiling iguais são sobrepostos com um deslocamento entre si.
 		/// @see ia::rl::Tile ia::rl::Tiling ia::rl::TileCoding
 		class Tiling {
+			friend class Snapshot;
+			friend class Checkpoint;
+			friend class FixedTileCoding;
+			friend class PolicyCompiler;
+
 		private:
 			std::vector<double> m_widths; ///< Largura de cada dimensão de um tile.
 			/// Offset para sobreposição dos tiling. Esta sobreposição é somada à posição de um Tile.
@@ -201,6 +229,11 @@ namespace ia {
 			/// @return Tile ativado pela entrada.
 			Tile get_tile(std::vector<double> input);
 
+			/// Encontra o tile ativado pela entrada reaproveitando um Tile existente.
+			/// @param input Entrada.
+			/// @param tile Tile que recebe a localização do tile ativado pela entrada.
+			void get_tile(const std::vector<double> &input, Tile &tile) const;
+
 			/// Carrega os parâmetros livres de um LinearFA.
 			/// @note Não utilize este operador em FeaturesMap, ao invés disto,
 			/// use em LinearFA.
@@ -286,9 +319,13 @@ namespace ia {
 		///		cout << sf.m_id << " "; // Mostra número id dos tiles
 		/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 		class TileCoding {
+			friend class Snapshot;
+			friend class Checkpoint;
+			friend class FixedTileCoding;
+			friend class PolicyCompiler;
+
 		private:
-			std::default_random_engine m_gen; ///< Gerador de números aleatórios.
-			std::uniform_real_distribution<float> m_distribution; ///< Distribuição uniforme entre 0 e 1.
+			Rng m_rng; ///< Gerador de números aleatórios dos deslocamentos dos tilings.
 
 			/// Mantém um id único para cada parâmetro livre do modelo.
 			/// @see TileCoding::get_or_gen_feature()
@@ -297,11 +334,36 @@ namespace ia {
 			std::vector<Tiling> m_tilings; ///< Tilings do modelo.
 			std::vector<std::map<Tile, int>> m_state_features; ///< Mapeamento dos tiles em um número id.
 
+			bool m_track_new; ///< Registra os tiles criados em m_new_tiles.
+			/// Tiling e Tile de cada tile criado desde o último checkpoint.
+			/// @see ia::rl::Checkpoint
+			std::vector<std::pair<int, Tile>> m_new_tiles;
+
+			/// Quantidade máxima de parâmetros livres ou 0 para não limitar.
+			/// @see set_budget()
+			int m_max_features;
+			std::vector<char> m_referenced; ///< Indica se cada parâmetro livre foi usado desde a última passagem de m_hand.
+			std::vector<std::pair<int, int>> m_owners; ///< Tiling e código hash do tile de cada parâmetro livre.
+			int m_hand; ///< Próximo parâmetro livre candidato à remoção.
+			unsigned int m_epoch; ///< Contador das chamadas de features(), usado para proteger os ids da chamada atual.
+			std::vector<unsigned int> m_pinned; ///< Valor de m_epoch na última chamada de features() que usou cada parâmetro livre.
+			long m_evictions; ///< Quantidade de tiles removidos.
+			std::vector<int> m_recycled; ///< Parâmetros livres reaproveitados desde a última chamada de take_recycled().
+
+			std::vector<double> m_input; ///< Variáveis do estado consultado por features().
+			Tile m_tile; ///< Tile de trabalho de features().
+
 			/// Cria ou recupera o id de um Tile dentro de um Tiling.
-			/// @param tile_map Tiles de um Tiling.
+			/// @param tiling Índice do Tiling.
 			/// @param tile Tile que deseja obter seu id.
 			/// @return Id do tile.
-			int get_or_gen_feature(std::map<Tile, int> &tile_map, Tile &tile);
+			int get_or_gen_feature(int tiling, Tile &tile);
+
+			/// Remove o tile menos usado recentemente e libera o seu parâmetro livre.
+			///
+			/// Os parâmetros livres já usados pela chamada atual de features() nunca são removidos.
+			/// @return Id do parâmetro livre liberado.
+			int evict();
 
 			/// Randomiza o deslocamento dos tilings.
 			/// @param dim_mask booleano do mesmo tamanho de **widths** que indica as
@@ -330,15 +392,77 @@ namespace ia {
 			/// @param num_tilings Números de tilings sobrepostos.
 			void add_tiling(std::vector<bool> &dim_mask, std::vector<double> &widths, int num_tilings);
 
+			/// Reinicia o gerador dos deslocamentos dos próximos tilings adicionados.
+			/// @param seed Semente.
+			void seed(uint64_t seed);
+
 			/// Obtém todos os parâmetros livres relacionados a um estado **s**.
 			/// @param s Estado **s** que se deseja obter os parâmetros livres.
 			/// @return Vetor com conjunto de parametros livres associados ao estado **s**
 			std::vector<StateFeature> features(ia::rl::State *s);
 
+			/// Obtém todos os parâmetros livres relacionados a um estado **s** reaproveitando um vetor.
+			///
+			/// As variáveis do estado são lidas com State::get_vars(). Nenhuma memória é alocada quando
+			/// todos os tiles já são conhecidos e o estado sobrescreve State::get_vars().
+			/// @param s Estado **s** que se deseja obter os parâmetros livres.
+			/// @param features Vetor que recebe os parametros livres associados ao estado **s**.
+			void features(ia::rl::State *s, std::vector<StateFeature> &features);
+
+			/// Obtém os parâmetros livres já existentes relacionados a uma entrada sem criar novos.
+			///
+			/// Tiles que ainda não possuem parâmetro livre são ignorados.
+			/// @param input Variáveis do estado, como retornado por State::to_vec().
+			/// @param tile Tile de trabalho reaproveitado entre as chamadas.
+			/// @param features Vetor que recebe os parâmetros livres encontrados.
+			void find_features(const std::vector<double> &input, Tile &tile, std::vector<StateFeature> &features) const;
+
 			/// Obtém a quantidade de parametros livres utilizados até o momento.
 			/// @return Quantidade de parâmetros livres utilizados.
 			int num_features();
 
+			/// Quantidade de tilings.
+			int num_tilings() const {
+				return m_tilings.size();
+			}
+
+			/// Tiling de índice **i**, na ordem em que foi adicionado.
+			/// @see ia::rl::FixedTileCoding::get_tile()
+			const Tiling &tiling(int i) const {
+				return m_tilings[i];
+			}
+
+			/// Limita a quantidade de parâmetros livres.
+			///
+			/// Quando o limite é atingido, cada novo tile reaproveita o parâmetro livre de um tile
+			/// pouco usado, escolhido pelo algoritmo CLOCK: os tiles usados desde a última
+			/// passagem do ponteiro de remoção recebem uma segunda chance. Os ids reaproveitados
+			/// são informados por take_recycled().
+			/// @param max_features Quantidade máxima de parâmetros livres ou 0 para não limitar.
+			/// Valores menores que num_features() são ajustados para num_features().
+			/// @return **False** se **max_features** é menor que a quantidade de tilings, caso em que
+			/// o limite não é alterado, ou **true**, caso contrário.
+			bool set_budget(int max_features);
+
+			/// Quantidade máxima de parâmetros livres ou 0, caso não haja limite.
+			int budget() const {
+				return m_max_features;
+			}
+
+			/// Quantidade de tiles removidos para respeitar o limite de set_budget().
+			long evictions() const {
+				return m_evictions;
+			}
+
+			/// Obtém e esquece os parâmetros livres reaproveitados desde a última chamada.
+			/// @param ids Recebe os ids reaproveitados.
+			void take_recycled(std::vector<int> &ids);
+
+			/// Indica se algum parâmetro livre foi reaproveitado desde a última chamada de take_recycled().
+			bool has_recycled() const {
+				return !m_recycled.empty();
+			}
+
 			/// Carrega os parâmetros livres de um LinearFA.
 			/// @note Não utilize este operador em TileCoding, ao invés disto,
 			/// use em LinearFA.
@@ -353,7 +477,9 @@ namespace ia {
 
 				// ((iii,...,...),(((...,iii),(...,iii)),((...,iii),(...,iii))))
 				char c;
-				do {
+				if (is.peek() == ')')
+					is.get(); // )
+				else do {
 					Tiling tiling;
 					is >> tiling; // ...
 					c = is.get(); // , or )
@@ -362,10 +488,14 @@ namespace ia {
 				
 				is.get(); // ,
 				is.get(); // (
-				do {
+				if (is.peek() == ')')
+					is.get(); // )
+				else do {
 					is.get(); // (
 					std::map<Tile, int> state_features;
-					do {
+					if (is.peek() == ')')
+						is.get(); // )
+					else do {
 						Tile key;
 						int value;
 
@@ -391,27 +521,21 @@ namespace ia {
 			/// @see operator<<(std::ostream, LinearFA)
 			friend std::ostream& operator<<(std::ostream& os, const TileCoding& tilecode) {
 				os << "((" << tilecode.m_feature_id << ",";
-				for(int i=0;i<tilecode.m_tilings.size()-1;i++)
-					os << tilecode.m_tilings[i] << ",";		
-				os << tilecode.m_tilings[tilecode.m_tilings.size()-1] << ")";
+				for(int i=0;i<tilecode.m_tilings.size();i++)
+					os << (i > 0 ? "," : "") << tilecode.m_tilings[i];
+				os << ")";
 
+				// an empty map is written as () so that it can be read back
 				os << ",(";
-				for(int i=0;i<tilecode.m_state_features.size()-1;i++) {
-					auto it = tilecode.m_state_features[i].begin();
-					auto it2 = --tilecode.m_state_features[i].end();
-					os << "(";
-					for(; it != it2; ++it)
-						os << "(" << it->first << "," << it->second << "),";
-					os << "(" << it->first << "," << it->second << ")";
-					os << "),";
+				for(int i=0;i<tilecode.m_state_features.size();i++) {
+					os << (i > 0 ? ",(" : "(");
+					bool first = true;
+					for (auto &entry : tilecode.m_state_features[i]) {
+						os << (first ? "(" : ",(") << entry.first << "," << entry.second << ")";
+						first = false;
+					}
+					os << ")";
 				}
-
-				auto it = tilecode.m_state_features[tilecode.m_state_features.size()-1].begin();
-				auto it2 = --tilecode.m_state_features[tilecode.m_state_features.size()-1].end();
-				os << "(";
-				for(; it != it2; ++it)
-					os << "(" << it->first << "," << it->second << "),";
-				os << "(" << it->first << "," << it->second << "))";
 				return os << "))";
 			}
 		};
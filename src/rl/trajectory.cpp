@@ -0,0 +1,171 @@
+/*
+ trajectory.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "trajectory.hpp"
+
+#include <cstring>
+
+using namespace ia::rl;
+
+TrajectoryWriter::TrajectoryWriter(const char *path, int dim, int flush_records) :
+    m_dim(dim), m_record_size(dim * sizeof(double) + sizeof(double) + 2 * sizeof(uint32_t)),
+    m_flush_records(flush_records > 0 ? flush_records : 1), m_pending(0)
+{
+    m_buffer.resize((size_t)m_flush_records * m_record_size);
+    m_file = fopen(path, "wb");
+    if (m_file == nullptr)
+        return;
+
+    TrajectoryHeader header;
+    memcpy(header.m_magic, "DTRJ", 4);
+    header.m_version = TrajectoryHeader::VERSION;
+    header.m_dim = m_dim;
+    header.m_record_size = m_record_size;
+    fwrite(&header, sizeof(header), 1, m_file);
+}
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+    close();
+}
+
+bool TrajectoryWriter::is_open() const
+{
+    return m_file != nullptr;
+}
+
+void TrajectoryWriter::append(const State &s, int action, double r, uint32_t flags)
+{
+    if (m_file == nullptr)
+        return;
+
+    s.get_vars(m_vars);
+    m_vars.resize(m_dim, 0.);
+
+    char *rec = m_buffer.data() + (size_t)m_pending * m_record_size;
+    memcpy(rec, m_vars.data(), m_dim * sizeof(double));
+    rec += m_dim * sizeof(double);
+    memcpy(rec, &r, sizeof(double));
+    rec += sizeof(double);
+    int32_t a = action;
+    memcpy(rec, &a, sizeof(int32_t));
+    rec += sizeof(int32_t);
+    memcpy(rec, &flags, sizeof(uint32_t));
+
+    if (++m_pending == m_flush_records)
+        flush();
+}
+
+void TrajectoryWriter::flush()
+{
+    if (m_file == nullptr)
+        return;
+
+    fwrite(m_buffer.data(), m_record_size, m_pending, m_file);
+    fflush(m_file);
+    m_pending = 0;
+}
+
+void TrajectoryWriter::close()
+{
+    if (m_file == nullptr)
+        return;
+
+    flush();
+    fclose(m_file);
+    m_file = nullptr;
+}
+
+void TrajectoryWriter::begin_episode(const State &s)
+{
+    append(s, -1, 0., TrajectoryHeader::BEGIN);
+}
+
+void TrajectoryWriter::transition(const Action &a, double r, const State &next_s, bool terminal)
+{
+    append(next_s, a.m_num, r, terminal ? TrajectoryHeader::TERMINAL : 0);
+}
+
+void TrajectoryWriter::end_episode()
+{
+    flush();
+}
+
+TrajectoryReader::TrajectoryReader() : m_dim(0), m_record_size(0), m_size(0) {}
+
+TrajectoryReader::~TrajectoryReader()
+{
+    close();
+}
+
+bool TrajectoryReader::open(const char *path)
+{
+    close();
+
+    TrajectoryHeader header;
+    if (!m_file.open(path) || m_file.size() < sizeof(header)) {
+        close();
+        return false;
+    }
+    memcpy(&header, m_file.data(), sizeof(header));
+    if (memcmp(header.m_magic, "DTRJ", 4) != 0 || header.m_version != TrajectoryHeader::VERSION ||
+        header.m_record_size != header.m_dim * sizeof(double) + sizeof(double) + 2 * sizeof(uint32_t)) {
+        close();
+        return false;
+    }
+
+    m_dim = header.m_dim;
+    m_record_size = header.m_record_size;
+    // a record truncated by an interrupted write is ignored
+    m_size = (m_file.size() - sizeof(header)) / m_record_size;
+    return true;
+}
+
+void TrajectoryReader::close()
+{
+    m_file.close();
+    m_dim = 0;
+    m_record_size = 0;
+    m_size = 0;
+}
+double TrajectoryReader::reward(int i) const
+{
+    double r;
+    memcpy(&r, record(i) + m_dim * sizeof(double), sizeof(double));
+    return r;
+}
+
+int TrajectoryReader::action(int i) const
+{
+    int32_t a;
+    memcpy(&a, record(i) + (m_dim + 1) * sizeof(double), sizeof(int32_t));
+    return a;
+}
+
+bool TrajectoryReader::is_begin(int i) const
+{
+    uint32_t flags;
+    memcpy(&flags, record(i) + (m_dim + 1) * sizeof(double) + sizeof(int32_t), sizeof(uint32_t));
+    return flags & TrajectoryHeader::BEGIN;
+}
+
+bool TrajectoryReader::is_terminal(int i) const
+{
+    uint32_t flags;
+    memcpy(&flags, record(i) + (m_dim + 1) * sizeof(double) + sizeof(int32_t), sizeof(uint32_t));
+    return flags & TrajectoryHeader::TERMINAL;
+}
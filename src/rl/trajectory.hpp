@@ -0,0 +1,182 @@
+/*
+ trajectory.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "episodesink.hpp"
+#include "mappedfile.hpp"
+
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+namespace ia {
+	namespace rl {
+		/// Cabeçalho de um arquivo de trajetórias.
+		///
+		/// O arquivo é composto por este cabeçalho seguido de registros de tamanho fixo
+		/// m_record_size. Cada registro contém, nesta ordem, as m_dim variáveis de um estado
+		/// (double), a recompensa (double), o número da ação (int32_t) e as flags (uint32_t).
+		/// O primeiro registro de um episódio contém o estado inicial, com ação -1 e a flag
+		/// BEGIN. Os demais contêm o próximo estado **s'**, a ação executada e a recompensa.
+		/// @see ia::rl::TrajectoryWriter ia::rl::TrajectoryReader
+		struct TrajectoryHeader {
+			char m_magic[4]; ///< Identificação do arquivo: "DTRJ".
+			uint32_t m_version; ///< Versão do formato.
+			uint32_t m_dim; ///< Quantidade de variáveis de um estado.
+			uint32_t m_record_size; ///< Tamanho em bytes de um registro.
+
+			static const uint32_t VERSION = 1; ///< Versão atual do formato.
+			static const uint32_t BEGIN = 1; ///< Flag do registro com o estado inicial de um episódio.
+			static const uint32_t TERMINAL = 2; ///< Flag do registro cujo estado é terminal.
+		};
+
+		/// Grava as transições dos episódios em um arquivo binário.
+		///
+		/// Os registros são acumulados em memória e gravados no arquivo a cada **flush_records**
+		/// registros, no fim de cada episódio e na destruição do objeto.
+		/// @see ia::rl::TrajectoryHeader ia::rl::TrajectoryReader
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::TrajectoryWriter writer("episodes.trj", 2); // estados com 2 variáveis
+		/// gdsl.m_sink = &writer;
+		/// for (int i = 0; i < 1000; i++) {
+		///     env->reset_env();
+		///     delete gdsl.run_learning(env, -1);
+		/// }
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class TrajectoryWriter : public EpisodeSink {
+		protected:
+			FILE *m_file; ///< Arquivo de destino.
+			int m_dim; ///< Quantidade de variáveis de um estado.
+			int m_record_size; ///< Tamanho em bytes de um registro.
+			int m_flush_records; ///< Quantidade de registros acumulados antes de gravar no arquivo.
+			int m_pending; ///< Quantidade de registros acumulados.
+			std::vector<char> m_buffer; ///< Registros acumulados.
+			std::vector<double> m_vars; ///< Variáveis do estado do último registro.
+
+			/// Acumula um registro.
+			void append(const State &s, int action, double r, uint32_t flags);
+
+		public:
+			/// Cria o arquivo de trajetórias, substituindo um arquivo existente.
+			/// @param path Caminho do arquivo.
+			/// @param dim Quantidade de variáveis de um estado. Estados maiores são truncados e
+			/// menores são completados com zeros.
+			/// @param flush_records Quantidade de registros acumulados antes de gravar no arquivo.
+			TrajectoryWriter(const char *path, int dim, int flush_records = 1024);
+
+			/// Grava os registros pendentes e fecha o arquivo.
+			virtual ~TrajectoryWriter();
+
+			/// Indica se o arquivo foi aberto com sucesso.
+			/// @return **True** se o arquivo está aberto ou **false**, caso contrário.
+			bool is_open() const;
+
+			/// Grava no arquivo os registros acumulados.
+			void flush();
+
+			/// Grava os registros pendentes e fecha o arquivo.
+			void close();
+
+			void begin_episode(const State &s);
+			void transition(const Action &a, double r, const State &next_s, bool terminal);
+			void end_episode();
+		};
+
+		/// Lê um arquivo gravado por TrajectoryWriter.
+		///
+		/// O arquivo é aberto com MappedFile e os registros são acessados diretamente, sem nenhuma cópia.
+		/// @see ia::rl::TrajectoryHeader ia::rl::TrajectoryWriter ia::rl::MappedFile
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::TrajectoryReader reader;
+		/// if (reader.open("episodes.trj")) {
+		///     double ret = 0;
+		///     for (int i = 0; i < reader.size(); i++)
+		///         if (!reader.is_begin(i))
+		///             ret += reader.reward(i);
+		/// }
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class TrajectoryReader {
+		protected:
+			MappedFile m_file; ///< Arquivo aberto.
+			int m_dim; ///< Quantidade de variáveis de um estado.
+			int m_record_size; ///< Tamanho em bytes de um registro.
+			int m_size; ///< Quantidade de registros.
+
+			/// Início de um registro.
+			const char *record(int i) const {
+				return m_file.data() + sizeof(TrajectoryHeader) + (size_t)i * m_record_size;
+			}
+
+		public:
+			/// Cria um leitor sem nenhum arquivo aberto.
+			TrajectoryReader();
+
+			/// Fecha o arquivo aberto.
+			virtual ~TrajectoryReader();
+
+			/// Abre um arquivo de trajetórias.
+			/// @param path Caminho do arquivo.
+			/// @return **True** se o arquivo foi aberto e possui um cabeçalho válido ou **false**, caso contrário.
+			bool open(const char *path);
+
+			/// Fecha o arquivo aberto.
+			void close();
+
+			/// Quantidade de registros.
+			int size() const {
+				return m_size;
+			}
+
+			/// Quantidade de variáveis de um estado.
+			int dim() const {
+				return m_dim;
+			}
+
+			/// Variáveis do estado de um registro.
+			/// @param i Índice do registro.
+			/// @return Ponteiro para as dim() variáveis do estado.
+			const double *state(int i) const {
+				return (const double *)record(i);
+			}
+
+			/// Recompensa de um registro.
+			/// @param i Índice do registro.
+			double reward(int i) const;
+
+			/// Número da ação de um registro.
+			/// @param i Índice do registro.
+			/// @return Número da ação ou -1 no registro inicial de um episódio.
+			int action(int i) const;
+
+			/// Indica se o registro contém o estado inicial de um episódio.
+			/// @param i Índice do registro.
+			bool is_begin(int i) const;
+
+			/// Indica se o estado do registro é terminal.
+			/// @param i Índice do registro.
+			bool is_terminal(int i) const;
+		};
+	}
+}
+
+#endif
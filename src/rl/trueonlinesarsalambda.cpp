@@ -0,0 +1,93 @@
+/*
+ trueonlinesarsalambda.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "trueonlinesarsalambda.hpp"
+
+using namespace ia::rl;
+
+TrueOnlineSarsaLambda::TrueOnlineSarsaLambda(double alpha, double lambda, double gamma, double E, double min_lambda, LinearFA *vfa) :
+    GDSarsaLambda(alpha, lambda, gamma, E, min_lambda, false, vfa) {}
+
+Episode *TrueOnlineSarsaLambda::run_learning(Env *env, int max_steps)
+{
+    State *curr_s = env->curr_obs();
+    Episode *ea = m_sink != nullptr ? new Episode() : new Episode(curr_s);
+    ea->m_owns_states = !env->pooled_states();
+    if (m_sink != nullptr)
+        m_sink->begin_episode(*curr_s);
+
+    m_curr_step = 0;
+    m_learner.m_traces.clear();
+    double old_Q = 0.;
+    double decay = m_lambda * m_gamma;
+
+    Action *action = egreedy_action(env, curr_s);
+    while (!env->is_terminal() && (m_curr_step < max_steps || max_steps == -1)) {
+        // get Q-value and features of (s,a)
+        double curr_Q = m_vfa->evaluate(*curr_s, *action);
+        FeatureSpan gradient = m_vfa->gradient(curr_s, action);
+        m_features.assign(gradient.begin(), gradient.end());
+
+        StepOutcome eo = env->step(action);
+        State *next_s = eo.m_op;
+
+        // determine next Q-value for outcome state
+        Action *next_a = egreedy_action(env, next_s);
+        double next_Q = 0.;
+        if (!eo.m_terminated)
+            next_Q = m_vfa->evaluate(*next_s, *next_a);
+
+        double r = eo.m_r;
+        m_curr_step++;
+        if (m_sink != nullptr)
+            m_sink->transition(*action, r, *next_s, eo.m_terminated);
+        else
+            ea->transition(action, next_s, r);
+        if (m_replay != nullptr)
+            m_replay->add(*curr_s, *action, r, *next_s, eo.m_terminated, &m_learner.m_mask);
+
+        double delta = r + (m_gamma * next_Q) - curr_Q;
+
+        // dutch traces: z = gamma*lambda*z + (1 - alpha*gamma*lambda*z'x)x
+        double zx = 0.;
+        for (StateFeature &sf : m_features)
+            zx += m_learner.m_traces.get(sf.m_id) * sf.m_value;
+        m_learner.m_traces.scale(decay);
+        double factor = 1. - m_alpha * decay * zx;
+        for (StateFeature &sf : m_features)
+            m_learner.m_traces.accumulate(sf.m_id, factor * sf.m_value);
+
+        // w = w + alpha*(delta + Q - Q_old)z - alpha*(Q - Q_old)x
+        m_learner.m_traces.apply(*m_vfa, m_alpha * (delta + curr_Q - old_Q));
+        for (StateFeature &sf : m_features)
+            m_vfa->update_weight(sf.m_id, -m_alpha * (curr_Q - old_Q) * sf.m_value);
+        m_learner.m_traces.prune(m_min_lambda);
+
+        // move on
+        if (m_sink != nullptr)
+            env->release_state(curr_s);
+        old_Q = next_Q;
+        curr_s = next_s;
+        action = next_a;
+    }
+
+    if (m_sink != nullptr) {
+        env->release_state(curr_s);
+        m_sink->end_episode();
+    }
+    return ea;
+}
@@ -0,0 +1,69 @@
+/*
+ trueonlinesarsalambda.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef TRUEONLINESARSALAMBDA_H
+#define TRUEONLINESARSALAMBDA_H
+
+#include "gdsarsalambda.hpp"
+
+namespace ia {
+	namespace rl {
+		/// Algoritmo True Online Sarsa Lambda com traços holandeses (dutch traces).
+		///
+		/// Utiliza os mesmos ambientes, aproximador de funções e política E-greedy do GDSarsaLambda,
+		/// mas a atualização dos pesos segue a versão true online do Sarsa Lambda, que costuma
+		/// exigir menos passos no ambiente para atingir a mesma política. O custo de cada passo
+		/// continua proporcional à quantidade de traços ativos.
+		/// @see ia::rl::GDSarsaLambda ia::rl::EligibilityTraces
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+        /// ia::rl::Env *env = new ... // Cria um ambiente Env
+		/// ia::rl::LinearFA fa(tc); // Constrói um aproximador de funções linear
+    	/// ia::rl::TrueOnlineSarsaLambda tosl(0.1, 0.9, 0.95, 0.1, 0.01, &fa); // Cria agente True Online Sarsa Lambda
+    	/// ia::rl::Episode *e = tosl.run_learning(env, 100); // Inicia aprendizagem de 1 episódio
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class TrueOnlineSarsaLambda : public GDSarsaLambda {
+		private:
+			std::vector<StateFeature> m_features; ///< Parâmetros livres do par \f$ (s,a) \f$ corrente.
+
+		public:
+			/// Cria um agente True Online Sarsa Lambda de aprendizagem por reforço.
+			/// @param alpha Taxa de aprendizagem.
+			/// @param lambda Taxa de decaimento.
+			/// @param gamma Desconto do retorno.
+			/// @param E Exploração.
+			/// @param min_lambda Valor absoluto mínimo do traço de elegibilidade.
+			/// @param vfa Aproximador de funções linear.
+			/// @see ia::rl::LinearFA
+			/// @note A liberação da memória utilizada pelo aproximador linear **vfa** não é liberada com
+			/// a destruição de um objeto TrueOnlineSarsaLambda.
+			TrueOnlineSarsaLambda(double alpha, double lambda, double gamma, double E, double min_lambda, LinearFA *vfa);
+
+			virtual ~TrueOnlineSarsaLambda() { }
+
+			/// Inicia a aprendizagem do agente em um episódio.
+			/// @param env Ambiente de aprendizagem por reforço.
+			/// @param max_steps Número máximo de passos permitidos no episódio.
+			/// @return Um objeto Episode com dados relativos à aprendizagem do agente durante o episódio.
+			/// @see ia::rl::GDSarsaLambda::run_learning()
+			Episode *run_learning(Env *env, int max_steps) override;
+		};
+	}
+}
+
+#endif
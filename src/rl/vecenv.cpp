@@ -0,0 +1,194 @@
+/*
+ vecenv.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "vecenv.hpp"
+
+using namespace ia::rl;
+
+VecEnv::VecEnv(std::vector<Env *> envs, GDSarsaLambda *agent, int num_threads) :
+    m_envs(envs), m_agent(agent), m_states(envs.size(), nullptr), m_actions(envs.size(), nullptr),
+    m_outcomes(envs.size(), StepOutcome(nullptr, 0., false)), m_curr_Q(envs.size()), m_steps(envs.size()),
+    m_returns(envs.size()), m_applicable(envs.size()), m_q(envs.size()), m_work(envs.size()),
+    m_batch(envs.size(), nullptr), m_generation(0), m_done(0), m_stop(false)
+{
+    for (int i = 0; i < envs.size(); i++)
+        m_learners.push_back(GDSarsaLambda::Learner(agent->rng().stream(i + 1)));
+    if (num_threads > (int)envs.size())
+        num_threads = envs.size();
+    for (int w = 1; w < num_threads; w++)
+        m_workers.push_back(std::thread(&VecEnv::worker_loop, this, w));
+}
+
+VecEnv::~VecEnv()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start_cv.notify_all();
+    for (std::thread &t : m_workers)
+        t.join();
+
+    for (int i = 0; i < m_envs.size(); i++)
+        m_envs[i]->release_state(m_states[i]);
+}
+
+void VecEnv::worker_loop(int worker)
+{
+    int generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_cv.wait(lock, [&] { return m_stop || m_generation != generation; });
+            if (m_stop)
+                return;
+            generation = m_generation;
+        }
+        step_partition(worker);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done++;
+        }
+        m_done_cv.notify_one();
+    }
+}
+
+void VecEnv::step_partition(int worker)
+{
+    int stride = m_workers.size() + 1;
+    for (int i = worker; i < m_envs.size(); i += stride)
+        m_outcomes[i] = m_envs[i]->step(m_actions[i]);
+}
+
+void VecEnv::step_all()
+{
+    if (!m_workers.empty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = 0;
+        m_generation++;
+    }
+    m_start_cv.notify_all();
+
+    step_partition(0);
+
+    if (!m_workers.empty()) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cv.wait(lock, [&] { return m_done == (int)m_workers.size(); });
+    }
+}
+
+void VecEnv::select_actions()
+{
+    for (int i = 0; i < m_envs.size(); i++) {
+        if (m_batch[i] == nullptr)
+            continue;
+        Rng &rng = m_learners[i].m_rng;
+        m_envs[i]->applicable_actions(m_batch[i], m_learners[i].m_mask, m_applicable[i]);
+        if (rng.uniform() < m_agent->m_E) {
+            m_actions[i] = m_applicable[i][rng.uniform_int(m_applicable[i].size())];
+            m_batch[i] = nullptr;
+        }
+    }
+
+    // one evaluation for every environment that exploits
+    m_agent->m_vfa->evaluate_batch(m_batch, m_applicable, m_q, m_work);
+    for (int i = 0; i < m_envs.size(); i++) {
+        if (m_batch[i] == nullptr)
+            continue;
+        int best = 0;
+        for (int j = 1; j < m_q[i].size(); j++) {
+            if (m_q[i][j] > m_q[i][best])
+                best = j;
+        }
+        m_actions[i] = m_applicable[i][best];
+        m_batch[i] = nullptr;
+    }
+}
+
+void VecEnv::end_episode(int i)
+{
+    // reset_env() may recycle pooled states, so the last state goes back before it
+    if (m_states[i] != nullptr)
+        m_envs[i]->release_state(m_states[i]);
+    m_states[i] = nullptr;
+}
+
+void VecEnv::begin_episode(int i)
+{
+    m_states[i] = m_envs[i]->curr_obs();
+    m_learners[i].m_traces.clear();
+    m_steps[i] = 0;
+    m_returns[i] = 0.;
+}
+
+int VecEnv::run_learning(int num_steps, int max_steps)
+{
+    int episodes = 0;
+    m_episode_returns.clear();
+
+    for (int i = 0; i < m_envs.size(); i++) {
+        if (m_states[i] == nullptr || m_envs[i]->is_terminal()) {
+            end_episode(i);
+            m_envs[i]->reset_env();
+            begin_episode(i);
+            m_batch[i] = m_states[i];
+        }
+    }
+    select_actions();
+
+    for (int step = 0; step < num_steps; step++) {
+        // get Q-value and gradient of every environment, in order
+        for (int i = 0; i < m_envs.size(); i++)
+            m_curr_Q[i] = m_agent->begin_step(m_states[i], m_actions[i], m_learners[i]);
+
+        step_all();
+
+        // choose the next action of every environment in one batch
+        for (int i = 0; i < m_envs.size(); i++)
+            m_batch[i] = m_outcomes[i].m_terminated ? nullptr : m_outcomes[i].m_op;
+        select_actions();
+
+        // update the shared weights in environment order
+        bool restarted = false;
+        for (int i = 0; i < m_envs.size(); i++) {
+            StepOutcome &eo = m_outcomes[i];
+            State *next_s = eo.m_op;
+
+            m_agent->end_step(eo, m_actions[i], m_curr_Q[i], m_learners[i]);
+
+            m_returns[i] += eo.m_r;
+            m_steps[i]++;
+
+            m_envs[i]->release_state(m_states[i]);
+            m_states[i] = next_s;
+
+            if (eo.m_terminated || (max_steps != -1 && m_steps[i] >= max_steps)) {
+                m_episode_returns.push_back(m_returns[i]);
+                episodes++;
+                end_episode(i);
+                m_envs[i]->reset_env();
+                begin_episode(i);
+                m_batch[i] = m_states[i];
+                restarted = true;
+            }
+        }
+        if (restarted)
+            select_actions();
+    }
+
+    return episodes;
+}
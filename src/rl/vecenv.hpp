@@ -0,0 +1,130 @@
+/*
+ vecenv.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef VECENV_H
+#define VECENV_H
+
+#include "gdsarsalambda.hpp"
+#include "env.hpp"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace ia {
+	namespace rl {
+		/// Executa vários ambientes em paralelo com um único agente GDSarsaLambda.
+		///
+		/// A cada passo, os ambientes executam suas ações em paralelo em um conjunto de threads,
+		/// as próximas ações de todos os ambientes são escolhidas com uma única avaliação em lote
+		/// do LinearFA e, em seguida, os pesos do LinearFA compartilhado são atualizados na ordem
+		/// dos ambientes. Somente Env::step()
+		/// é chamado fora da thread que chama run_learning(), portanto o resultado da aprendizagem
+		/// é determinístico para um mesmo número de ambientes.
+		/// @see ia::rl::GDSarsaLambda ia::rl::Env
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// std::vector<ia::rl::Env *> envs { new ..., new ..., new ..., new ... }; // Cria 4 ambientes
+		/// ia::rl::GDSarsaLambda gdsl(0.1, 0.9, 0.95, 0.1, 0.01, true, &fa); // Cria agente
+		/// ia::rl::VecEnv venv(envs, &gdsl, 4); // Executa os ambientes em 4 threads
+		/// int episodes = venv.run_learning(10000, 100); // Executa 10000 passos em cada ambiente
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class VecEnv {
+		private:
+			std::vector<Env *> m_envs; ///< Ambientes.
+			GDSarsaLambda *m_agent; ///< Agente que escolhe as ações e cujo LinearFA é atualizado.
+
+			std::vector<State *> m_states; ///< Estado atual de cada ambiente.
+			std::vector<Action *> m_actions; ///< Ação escolhida para cada ambiente.
+			std::vector<StepOutcome> m_outcomes; ///< Resultado do último passo de cada ambiente.
+			std::vector<double> m_curr_Q; ///< Valor \f$ Q(s,a) \f$ do passo corrente de cada ambiente.
+			std::vector<GDSarsaLambda::Learner> m_learners; ///< Traços e números aleatórios de cada ambiente.
+			std::vector<int> m_steps; ///< Passos do episódio corrente de cada ambiente.
+			std::vector<double> m_returns; ///< Retorno acumulado do episódio corrente de cada ambiente.
+
+			std::vector<std::vector<Action *>> m_applicable; ///< Ações realizáveis no estado de cada ambiente.
+			std::vector<std::vector<double>> m_q; ///< Valores **Q** das ações em m_applicable.
+			std::vector<std::vector<StateFeature>> m_work; ///< Vetores de trabalho de LinearFA::evaluate_batch().
+			std::vector<State *> m_batch; ///< Estados que aguardam a escolha de uma ação ou nullptr.
+
+			std::vector<std::thread> m_workers; ///< Threads que executam os ambientes.
+			std::mutex m_mutex; ///< Protege a sincronização com as threads.
+			std::condition_variable m_start_cv; ///< Sinaliza o início de um passo para as threads.
+			std::condition_variable m_done_cv; ///< Sinaliza o fim de um passo para a thread principal.
+			int m_generation; ///< Número do passo em execução pelas threads.
+			int m_done; ///< Quantidade de threads que terminaram o passo corrente.
+			bool m_stop; ///< Encerra as threads.
+
+			/// Laço executado por cada thread.
+			/// @param worker Índice da thread.
+			void worker_loop(int worker);
+
+			/// Executa as ações dos ambientes de uma partição.
+			/// @param worker Índice da partição.
+			void step_partition(int worker);
+
+			/// Executa em paralelo a ação escolhida para cada ambiente.
+			void step_all();
+
+			/// Escolhe, seguindo uma política E-greedy, uma ação para cada estado de m_batch.
+			///
+			/// Todos os estados que não exploram são avaliados juntos por LinearFA::evaluate_batch().
+			/// As ações escolhidas são gravadas em m_actions.
+			void select_actions();
+
+			/// Libera o último estado de um ambiente. Deve ser chamada antes de Env::reset_env().
+			/// @param i Índice do ambiente.
+			void end_episode(int i);
+
+			/// Inicia um novo episódio em um ambiente já reiniciado. A ação inicial é escolhida por
+			/// select_actions().
+			/// @param i Índice do ambiente.
+			void begin_episode(int i);
+
+		public:
+			std::vector<double> m_episode_returns; ///< Retorno dos episódios encerrados na última chamada a run_learning().
+
+			/// Cria um executor de ambientes em paralelo.
+			/// @param envs Ambientes. Cada ambiente deve ser independente dos demais.
+			/// @param agent Agente que escolhe as ações e cujo LinearFA é atualizado.
+			/// @param num_threads Quantidade de threads, incluindo a thread que chama run_learning().
+			/// @note A memória dos ambientes e do agente não é liberada com a destruição de um objeto VecEnv.
+			VecEnv(std::vector<Env *> envs, GDSarsaLambda *agent, int num_threads);
+
+			virtual ~VecEnv();
+
+			/// Executa passos de aprendizagem em todos os ambientes.
+			///
+			/// Ambientes que atingem um estado terminal ou **max_steps** passos são reiniciados com
+			/// Env::reset_env() e continuam em um novo episódio.
+			/// @param num_steps Número de passos executados em cada ambiente.
+			/// @param max_steps Número máximo de passos de um episódio ou -1 para não limitar.
+			/// @return Quantidade de episódios encerrados.
+			int run_learning(int num_steps, int max_steps);
+
+			/// Quantidade de ambientes.
+			/// @return Quantidade de ambientes.
+			int num_envs() {
+				return m_envs.size();
+			}
+		};
+	}
+}
+
+#endif
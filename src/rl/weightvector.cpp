@@ -0,0 +1,96 @@
+/*
+ weightvector.cpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#include "weightvector.hpp"
+
+#include <math.h>
+
+using namespace ia::rl;
+
+// each thread draws its own rounding sequence, so concurrent updates need no locking
+static thread_local uint64_t dither_state = 0x853c49e6748fea9bULL;
+
+static double next_dither()
+{
+    uint64_t z = (dither_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return ((z ^ (z >> 31)) >> 11) * (1. / 9007199254740992.);
+}
+
+uint16_t WeightVector::add_stochastic(uint16_t h, double delta) const
+{
+    double x = decode(h) + delta;
+    uint16_t nearest = encode(x);
+    double y = decode(nearest);
+    if (y == x || !isfinite(y))
+        return nearest;
+
+    // neighbour of nearest on the other side of x, stepping the sign-magnitude encoding
+    uint16_t other;
+    bool up = x > y;
+    if ((nearest & 0x7FFF) == 0)
+        other = up ? 0x0001 : 0x8001;
+    else
+        other = (up != ((nearest & 0x8000) != 0)) ? nearest + 1 : nearest - 1;
+    double z = decode(other);
+    if (!isfinite(z))
+        return nearest;
+
+    // rounds to other with probability |x - y| / |z - y|, so the expected result is x
+    return next_dither() < (x - y) / (z - y) ? other : nearest;
+}
+
+void WeightVector::set_precision(Precision precision)
+{
+    if (precision == m_precision)
+        return;
+    std::vector<double> values(size());
+    for (int i = 0; i < (int)values.size(); i++)
+        values[i] = (*this)[i];
+    clear();
+    m_precision = precision;
+    assign(values.data(), values.data() + values.size());
+}
+
+void WeightVector::resize(int n, double value)
+{
+    switch (m_precision) {
+    case DOUBLE: m_double.resize(n, value); break;
+    case FLOAT: m_float.resize(n, (float)value); break;
+    default: m_half.resize(n, encode(value));
+    }
+}
+
+void WeightVector::assign(const double *first, const double *last)
+{
+    clear();
+    if (m_precision == DOUBLE) {
+        m_double.assign(first, last);
+        return;
+    }
+    resize(last - first, 0.);
+    for (int i = 0; first + i != last; i++)
+        set(i, first[i]);
+}
+
+void WeightVector::clear()
+{
+    m_double.clear();
+    m_float.clear();
+    m_half.clear();
+}
@@ -0,0 +1,241 @@
+/*
+ weightvector.hpp
+ Copyright (c) 2023 DEVTAG. Todos os direitos reservados.
+  
+ Este código faz parte do software SLAMduino, um produto desenvolvido
+ pela DEVTAG. Todos os direitos reservados. A reprodução, distribuição,
+ modificação ou uso deste software sem a devida autorização por escrito
+ da DEVTAG é estritamente proibida.
+  
+ A DEVTAG não se responsabiliza por qualquer dano ou prejuízo causado
+ pelo uso indevido deste software. Utilize-o por sua conta e risco.
+  
+ Para obter mais informações, entre em contato com a DEVTAG em:
+ davi@devtag.com.br
+ https://devtag.com.br
+ */
+
+#ifndef WEIGHTVECTOR_H
+#define WEIGHTVECTOR_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ia {
+	namespace rl {
+		/// Vetor de valores reais armazenados com precisão configurável.
+		///
+		/// Os valores são lidos e escritos como double, mas podem ser armazenados em float (32 bits),
+		/// half (16 bits, IEEE 754) ou bfloat16 (16 bits, mesmo expoente do float). Somente o
+		/// armazenamento é reduzido: as contas são feitas em double e o resultado é arredondado ao
+		/// ser guardado. Em half e bfloat16, add() usa arredondamento estocástico, de modo que
+		/// incrementos menores que a resolução do valor armazenado não são perdidos em média.
+		/// @see ia::rl::LinearFA::set_precision()
+		///
+        /// ### Exemplo
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~.cpp
+		/// ia::rl::WeightVector w(ia::rl::WeightVector::BFLOAT16);
+		/// w.resize(1000, 0.); // 2000 bytes
+		/// w.add(10, 0.001);
+		/// double v = w[10];
+        /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		class WeightVector {
+		public:
+			/// Precisão do armazenamento.
+			enum Precision {
+				DOUBLE, ///< 64 bits.
+				FLOAT, ///< 32 bits.
+				HALF, ///< 16 bits, 5 de expoente e 10 de mantissa.
+				BFLOAT16 ///< 16 bits, 8 de expoente e 7 de mantissa.
+			};
+
+		private:
+			Precision m_precision; ///< Precisão do armazenamento.
+			std::vector<double> m_double; ///< Valores em DOUBLE.
+			std::vector<float> m_float; ///< Valores em FLOAT.
+			std::vector<uint16_t> m_half; ///< Valores em HALF ou BFLOAT16.
+
+			/// Converte um valor de 16 bits para double.
+			double decode(uint16_t h) const {
+				return m_precision == HALF ? half_to_float(h) : bfloat16_to_float(h);
+			}
+
+			/// Converte um valor para 16 bits com arredondamento para o mais próximo.
+			uint16_t encode(double v) const {
+				return m_precision == HALF ? float_to_half((float)v) : float_to_bfloat16((float)v);
+			}
+
+			/// Soma **delta** a um valor de 16 bits com arredondamento estocástico.
+			/// @param h Valor armazenado.
+			/// @param delta Incremento.
+			/// @return Novo valor armazenado.
+			uint16_t add_stochastic(uint16_t h, double delta) const;
+
+		public:
+			/// Cria um vetor vazio.
+			/// @param precision Precisão do armazenamento.
+			WeightVector(Precision precision = DOUBLE) : m_precision(precision) { }
+
+			/// Precisão do armazenamento.
+			Precision precision() const {
+				return m_precision;
+			}
+
+			/// Altera a precisão do armazenamento, convertendo os valores existentes.
+			/// @param precision Nova precisão.
+			void set_precision(Precision precision);
+
+			/// Quantidade de bytes usados por valor em uma precisão.
+			static int element_size(Precision precision) {
+				return precision == DOUBLE ? 8 : precision == FLOAT ? 4 : 2;
+			}
+
+			/// Quantidade de valores.
+			int size() const {
+				return m_precision == DOUBLE ? m_double.size() : m_precision == FLOAT ? m_float.size() : m_half.size();
+			}
+
+			/// Indica se o vetor está vazio.
+			bool empty() const {
+				return size() == 0;
+			}
+
+			/// Altera a quantidade de valores.
+			/// @param n Nova quantidade.
+			/// @param value Valor dos novos elementos.
+			void resize(int n, double value);
+
+			/// Substitui todos os valores.
+			/// @param first Início dos novos valores.
+			/// @param last Fim dos novos valores.
+			void assign(const double *first, const double *last);
+
+			/// Remove todos os valores.
+			void clear();
+
+			/// Obtém um valor.
+			/// @param i Índice, menor que size().
+			double operator[](int i) const {
+				switch (m_precision) {
+				case DOUBLE: return m_double[i];
+				case FLOAT: return m_float[i];
+				case HALF: return half_to_float(m_half[i]);
+				default: return bfloat16_to_float(m_half[i]);
+				}
+			}
+
+			/// Substitui um valor.
+			/// @param i Índice, menor que size().
+			/// @param value Novo valor, arredondado para o mais próximo.
+			void set(int i, double value) {
+				switch (m_precision) {
+				case DOUBLE: m_double[i] = value; break;
+				case FLOAT: m_float[i] = (float)value; break;
+				default: m_half[i] = encode(value);
+				}
+			}
+
+			/// Soma um incremento a um valor.
+			/// @param i Índice, menor que size().
+			/// @param delta Incremento.
+			void add(int i, double delta) {
+				switch (m_precision) {
+				case DOUBLE: m_double[i] += delta; break;
+				case FLOAT: m_float[i] = (float)(m_float[i] + delta); break;
+				default: m_half[i] = add_stochastic(m_half[i], delta);
+				}
+			}
+
+			/// Multiplica um valor por um fator.
+			///
+			/// Nas precisões de 16 bits o resultado usa arredondamento estocástico, como add(), para
+			/// que fatores próximos de 1 não deixem o valor parado.
+			/// @param i Índice, menor que size().
+			/// @param factor Fator de multiplicação.
+			void scale(int i, double factor) {
+				switch (m_precision) {
+				case DOUBLE: m_double[i] *= factor; break;
+				case FLOAT: m_float[i] = (float)(m_float[i] * factor); break;
+				default: {
+					double v = decode(m_half[i]);
+					m_half[i] = add_stochastic(m_half[i], v * factor - v);
+				}
+				}
+			}
+
+			/// Converte um float para half com arredondamento para o mais próximo.
+			static uint16_t float_to_half(float f) {
+				uint32_t x;
+				memcpy(&x, &f, sizeof(x));
+				uint32_t sign = (x >> 16) & 0x8000;
+				uint32_t mag = x & 0x7FFFFFFF;
+				if (mag >= 0x7F800000) // inf e NaN
+					return sign | 0x7C00 | (mag > 0x7F800000 ? 0x200 : 0);
+				if (mag >= 0x477FF000) // arredonda para inf
+					return sign | 0x7C00;
+				if (mag < 0x38800000) { // subnormal em half
+					if (mag < 0x33000000)
+						return sign;
+					int shift = 126 - (mag >> 23);
+					uint32_t m = (mag & 0x7FFFFF) | 0x800000;
+					uint32_t h = m >> shift;
+					uint32_t rem = m & ((1u << shift) - 1);
+					uint32_t halfway = 1u << (shift - 1);
+					if (rem > halfway || (rem == halfway && (h & 1)))
+						h++;
+					return sign | h;
+				}
+				uint32_t h = (mag - 0x38000000) >> 13;
+				uint32_t rem = mag & 0x1FFF;
+				if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+					h++;
+				return sign | h;
+			}
+
+			/// Converte um half para float.
+			static float half_to_float(uint16_t h) {
+				uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+				uint32_t exp = (h >> 10) & 0x1F;
+				uint32_t man = h & 0x3FF;
+				uint32_t x;
+				if (exp == 0x1F)
+					x = sign | 0x7F800000 | (man << 13);
+				else if (exp != 0)
+					x = sign | ((exp + 112) << 23) | (man << 13);
+				else if (man == 0)
+					x = sign;
+				else {
+					uint32_t e = 113;
+					while (!(man & 0x400)) {
+						man <<= 1;
+						e--;
+					}
+					x = sign | (e << 23) | ((man & 0x3FF) << 13);
+				}
+				float f;
+				memcpy(&f, &x, sizeof(f));
+				return f;
+			}
+
+			/// Converte um float para bfloat16 com arredondamento para o mais próximo.
+			static uint16_t float_to_bfloat16(float f) {
+				uint32_t x;
+				memcpy(&x, &f, sizeof(x));
+				if ((x & 0x7FFFFFFF) > 0x7F800000)
+					return (x >> 16) | 0x40;
+				return (x + 0x7FFF + ((x >> 16) & 1)) >> 16;
+			}
+
+			/// Converte um bfloat16 para float.
+			static float bfloat16_to_float(uint16_t h) {
+				uint32_t x = (uint32_t)h << 16;
+				float f;
+				memcpy(&f, &x, sizeof(f));
+				return f;
+			}
+		};
+	}
+}
+
+#endif